@@ -1,10 +1,15 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <functional>
 #include <ranges>
-#include <unordered_set>
+#include <span>
+#include <string>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include "game_enhancer/achis/conditions.h"
 #include "game_enhancer/achis/progress_tracker.h"
@@ -38,6 +43,71 @@ namespace GE
     {
     };
 
+    /*
+     * Callbacks per Status, callbacks at index Status::All are not bound to any status.
+     */
+    template <typename... Args>
+    using StatusCallbacks = std::array<std::vector<std::function<void(Args...)>>, static_cast<size_t>(Status::All) + 1>;
+
+    /*
+     * Data read by the update callbacks of an achievement, see AchievementBuilder::DependsOn.
+     * m_size 0 means the whole object of m_layout. Pointers are stored translated, so a pointer field also changes when
+     * anything reachable through it changed, and the whole object changes when anything in its subtree changed.
+     */
+    struct Dependency
+    {
+        std::string m_layout;
+        size_t m_offset = 0;
+        size_t m_size = 0;
+    };
+
+    /*
+     * Status and progress notifications of achievements updated on a worker thread are queued instead of being called, so
+     * they can be delivered afterwards in a deterministic order, see AchievementManager::SetParallelUpdate.
+     */
+    class NotificationQueue
+    {
+        static inline thread_local NotificationQueue* t_current = nullptr;
+
+        std::vector<std::function<void()>> m_notifications;
+
+    public:
+        /*
+         * Makes aQueue the queue of the calling thread for the lifetime of the scope.
+         */
+        class Scope
+        {
+            NotificationQueue* m_previous;
+
+        public:
+            Scope(NotificationQueue& aQueue)
+                : m_previous(std::exchange(t_current, &aQueue))
+            {
+            }
+
+            ~Scope() { t_current = m_previous; }
+        };
+
+        /*
+         * Queue of the calling thread, nullptr when notifications are called right away.
+         */
+        static NotificationQueue* GetCurrent() { return t_current; }
+
+        void Push(std::function<void()> aNotification) { m_notifications.push_back(std::move(aNotification)); }
+
+        /*
+         * Calls queued notifications in the order they were pushed and clears the queue.
+         */
+        void Deliver()
+        {
+            for (auto& notification : m_notifications)
+            {
+                notification();
+            }
+            m_notifications.clear();
+        }
+    };
+
     template <typename Metadata, typename SharedData, typename DataAccess = GE::DataAccessor>
     struct Achievement
     {
@@ -55,8 +125,10 @@ namespace GE
 
         virtual PMA::ScopedTokenPtr OnStatusChanged(const std::function<void(Status, Status)>& aCallback) = 0;
 
-        virtual PMA::ScopedTokenPtr OnProgressMade(
-            const std::function<void(const std::unordered_set<ProgressTracker*>&)>& aCallback) = 0;
+        /*
+         * The span is valid only during the call.
+         */
+        virtual PMA::ScopedTokenPtr OnProgressMade(const std::function<void(std::span<ProgressTracker* const>)>& aCallback) = 0;
 
         /*
          * Metadata can be used to store name, description, difficulty, reward, ...
@@ -64,7 +136,24 @@ namespace GE
          */
         virtual const Metadata& GetMetadata() const = 0;
 
-        virtual const std::unordered_set<ProgressTracker*>& GetProgress(ConditionType aConditionType) const = 0;
+        virtual std::span<ProgressTracker* const> GetProgress(ConditionType aConditionType) const = 0;
+
+        /*
+         * Empty when the achievement has to be updated every frame.
+         */
+        virtual const std::vector<Dependency>& GetDependencies() const = 0;
+
+        /*
+         * True when the achievement needs an update regardless of its dependencies, e.g. its status changed, a pause was
+         * requested or one of its timers ticked.
+         */
+        virtual bool IsUpdateDue() const = 0;
+
+        /*
+         * True when trackers changed since the last call, also when unmet preconditions kept OnProgressMade from reporting
+         * the change. Used to journal every change, see AchievementManager::EnableJournal.
+         */
+        virtual bool TakeProgressChanged() = 0;
 
         virtual void Serialize(BinWriter aOut) const = 0;
         virtual void Deserialize(BinReader aIn) = 0;
@@ -84,27 +173,30 @@ namespace GE
 
             Status m_status = Status::Inactive;
             Status m_prePauseStatus = Status::Inactive;
+            // Status changed since the last update, callbacks of the new status have not run yet
+            bool m_statusChanged = false;
             std::atomic<PauseRequest> m_pauseRequest = PauseRequest::None;
             const Metadata m_metadata;
             ProgressData m_progressData;
-            std::function<void(ProgressData&, std::unordered_map<ConditionType, std::unordered_set<ProgressTracker*>>&)>
-                m_conditionsSetup;
-            std::unordered_map<ConditionType, std::unordered_set<ProgressTracker*>> m_progressTrackers;
+            std::function<void(ProgressData&, ConditionTrackers&)> m_conditionsSetup;
+            ConditionTrackers m_conditions;
+            std::vector<ProgressTrackerTimer*> m_timers;
+            const std::vector<Dependency> m_dependencies;
 
-            std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> m_updateCallbacks;
-            std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> m_onEnteringCallbacks;
-            std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> m_onLeavingCallbacks;
+            StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> m_updateCallbacks;
+            StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> m_onEnteringCallbacks;
+            StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> m_onLeavingCallbacks;
 
             PMA::Callback<Status, Status> m_onStatusChangedCallback;
-            PMA::Callback<const std::unordered_set<ProgressTracker*>&> m_onProgressMadeCallback;
+            PMA::Callback<std::span<ProgressTracker* const>> m_onProgressMadeCallback;
+            // Reused by every update, see BaseProgressData::ExtractModifiedTrackers
+            std::vector<ProgressTracker*> m_modifiedTrackers;
 
             std::shared_ptr<spdlog::logger> m_logger;
 
             void ProcessInactive(const DataAccess& aDataAccess, const SharedData& aSharedData)
             {
-                if (std::ranges::any_of(m_progressTrackers[ConditionType::Activator], [](const ProgressTracker* tracker) {
-                        return !tracker->IsCompleted();
-                    }))
+                if (!m_conditions.AllCompleted(ConditionType::Activator))
                 {
                     return;
                 }
@@ -113,20 +205,12 @@ namespace GE
 
             void ProcessActive(const DataAccess& aDataAccess, const SharedData& aSharedData)
             {
-                if (std::ranges::all_of(m_progressTrackers[ConditionType::Completer], [](const ProgressTracker* tracker) {
-                        return tracker->IsCompleted();
-                    }))
+                if (m_conditions.AllCompleted(ConditionType::Completer))
                 {
-                    bool validated = std::ranges::all_of(m_progressTrackers[ConditionType::Validator],
-                                                         [](const ProgressTracker* tracker) {
-                                                             return tracker->IsCompleted();
-                                                         });
+                    bool validated = m_conditions.AllCompleted(ConditionType::Validator);
                     SetStatus(validated ? Status::Completed : Status::Failed, aDataAccess, aSharedData, m_progressData);
                 }
-                if (m_status == Status::Active &&
-                    std::ranges::any_of(m_progressTrackers[ConditionType::Failer], [](const ProgressTracker* tracker) {
-                        return tracker->IsCompleted();
-                    }))
+                if (m_status == Status::Active && m_conditions.AnyCompleted(ConditionType::Failer))
                 {
                     SetStatus(Status::Failed, aDataAccess, aSharedData, m_progressData);
                 }
@@ -134,22 +218,37 @@ namespace GE
 
             void ProcessFailed(const DataAccess& aDataAccess, const SharedData& aSharedData)
             {
-                if (std::ranges::all_of(m_progressTrackers[ConditionType::Reseter], [](const ProgressTracker* tracker) {
-                        return tracker->IsCompleted();
-                    }))
+                if (m_conditions.AllCompleted(ConditionType::Reseter))
                 {
                     SetStatus(Status::Inactive, aDataAccess, aSharedData, m_progressData);
                     m_progressData = ProgressData();
-                    m_progressTrackers.clear();
-                    m_conditionsSetup(m_progressData, m_progressTrackers);
+                    m_conditions.Clear();
+                    m_conditionsSetup(m_progressData, m_conditions);
+                    CollectTimers();
+                }
+            }
+
+            void CollectTimers()
+            {
+                m_timers.clear();
+                for (uint32_t i = 0; i < static_cast<uint32_t>(ConditionType::All); ++i)
+                {
+                    for (auto* tracker : m_conditions.Get(static_cast<ConditionType>(i)))
+                    {
+                        auto* timer = dynamic_cast<ProgressTrackerTimer*>(tracker);
+                        if (timer && std::ranges::find(m_timers, timer) == m_timers.end())
+                        {
+                            m_timers.push_back(timer);
+                        }
+                    }
                 }
             }
 
             void RunUpdateForStatus(Status aStatus, const DataAccess& aDataAccess, const SharedData& aSharedData)
             {
-                for (const auto& cb : m_updateCallbacks)
+                for (const auto& cb : m_updateCallbacks[static_cast<size_t>(aStatus)])
                 {
-                    cb(aStatus, aDataAccess, aSharedData, m_progressData);
+                    cb(aDataAccess, aSharedData, m_progressData);
                 }
             }
 
@@ -175,17 +274,6 @@ namespace GE
 
             // clang-format on
 
-            auto CreateStatusLogger(Status aStatus, const std::string& aAction)
-            {
-                return [=](Status status, const DataAccess&, const SharedData&, ProgressData&) {
-                    if (aStatus != status)
-                    {
-                        return;
-                    }
-                    m_logger->info("Achievement '{}' {} status '{}'", TryGetName(), aAction, to_string(aStatus));
-                };
-            }
-
             bool ProcessPause(const DataAccess& aDataAccess, const SharedData& aSharedData)
             {
                 auto pauseRequest = m_pauseRequest.exchange(PauseRequest::None);
@@ -204,32 +292,21 @@ namespace GE
         public:
             AchievementImpl(
                 Metadata aMetadata,
-                std::function<void(ProgressData&, std::unordered_map<ConditionType, std::unordered_set<ProgressTracker*>>&)>
-                    aConditionsSetup,
-                std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> aUpdateCallbacks,
-                std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> aEnteringCallbacks,
-                std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> aLeavingCallbacks,
-                std::shared_ptr<spdlog::logger> aLogger)
+                std::function<void(ProgressData&, ConditionTrackers&)> aConditionsSetup,
+                StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> aUpdateCallbacks,
+                StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> aEnteringCallbacks,
+                StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> aLeavingCallbacks,
+                std::vector<Dependency> aDependencies, std::shared_ptr<spdlog::logger> aLogger)
                 : m_metadata(std::move(aMetadata))
                 , m_conditionsSetup(std::move(aConditionsSetup))
+                , m_dependencies(std::move(aDependencies))
                 , m_updateCallbacks(std::move(aUpdateCallbacks))
                 , m_onEnteringCallbacks(std::move(aEnteringCallbacks))
                 , m_onLeavingCallbacks(std::move(aLeavingCallbacks))
                 , m_logger(std::move(aLogger))
             {
-                for (uint32_t i = 0; i < static_cast<uint32_t>(Status::All); ++i)
-                {
-                    Status status = static_cast<Status>(i);
-                    m_onEnteringCallbacks.push_back(CreateStatusLogger(status, "entering"));
-                    m_onLeavingCallbacks.push_back(CreateStatusLogger(status, "leaving"));
-                }
-
-                for (uint32_t i = 0; i < static_cast<uint32_t>(ConditionType::All); ++i)
-                {
-                    ConditionType conditionType = static_cast<ConditionType>(i);
-                    m_progressTrackers[conditionType] = {};
-                }
-                m_conditionsSetup(m_progressData, m_progressTrackers);
+                m_conditionsSetup(m_progressData, m_conditions);
+                CollectTimers();
             }
 
             void Update(const DataAccess& aDataAccess, const SharedData& aSharedData) override
@@ -238,6 +315,7 @@ namespace GE
                 {
                     return;
                 }
+                m_statusChanged = false;
 
                 if (ProcessPause(aDataAccess, aSharedData))
                 {
@@ -246,22 +324,30 @@ namespace GE
                 }
 
                 RunUpdateForStatus(Status::All, aDataAccess, aSharedData);
-                if (std::ranges::any_of(m_progressTrackers[ConditionType::Precondition], [](const ProgressTracker* tracker) {
-                        return !tracker->IsCompleted();
-                    }))
+                if (!m_conditions.AllCompleted(ConditionType::Precondition))
                 {
                     return;
                 }
 
                 RunUpdateForStatus(m_status, aDataAccess, aSharedData);
 
-                auto modifiedTrackers = m_progressData.ExtractModifiedTrackers();
-                if (modifiedTrackers.empty())
+                m_progressData.ExtractModifiedTrackers(m_modifiedTrackers);
+                if (m_modifiedTrackers.empty())
                 {
                     return;  // no progress made
                 }
 
-                m_onProgressMadeCallback(modifiedTrackers);
+                if (auto* queue = NotificationQueue::GetCurrent())
+                {
+                    // Delivered after the update, the trackers have to be copied
+                    queue->Push([this, modifiedTrackers = m_modifiedTrackers]() {
+                        m_onProgressMadeCallback(modifiedTrackers);
+                    });
+                }
+                else
+                {
+                    m_onProgressMadeCallback(m_modifiedTrackers);
+                }
 
                 switch (m_status)
                 {
@@ -291,6 +377,27 @@ namespace GE
 
             Status GetStatus() const override { return m_status; }
 
+            const std::vector<Dependency>& GetDependencies() const override { return m_dependencies; }
+
+            bool IsUpdateDue() const override
+            {
+                if (m_status == Status::Disabled || m_status == Status::Completed)
+                {
+                    return false;
+                }
+                return m_statusChanged || m_pauseRequest != PauseRequest::None ||
+                       std::ranges::any_of(m_timers, &ProgressTrackerTimer::IsUpdateDue);
+            }
+
+            bool TakeProgressChanged() override
+            {
+                if constexpr (std::is_base_of_v<BaseProgressData, ProgressData>)
+                {
+                    return m_progressData.TakeChanged();
+                }
+                return false;
+            }
+
             void SetStatus(Status aStatus)
             {
                 if (m_status == aStatus)
@@ -299,7 +406,17 @@ namespace GE
                 }
                 auto oldStatus = m_status;
                 m_status = aStatus;
-                m_onStatusChangedCallback(m_status, oldStatus);
+                m_statusChanged = true;
+                if (auto* queue = NotificationQueue::GetCurrent())
+                {
+                    queue->Push([this, aStatus, oldStatus]() {
+                        m_onStatusChangedCallback(aStatus, oldStatus);
+                    });
+                }
+                else
+                {
+                    m_onStatusChangedCallback(m_status, oldStatus);
+                }
             }
 
             void SetStatus(Status aStatus, const DataAccess& aDataAccess, const SharedData& aSharedData,
@@ -309,13 +426,18 @@ namespace GE
                 {
                     return;
                 }
-                for (const auto& cb : m_onLeavingCallbacks)
+                if (m_logger->should_log(spdlog::level::info))
+                {
+                    m_logger->info("Achievement '{}' leaving status '{}', entering status '{}'", TryGetName(),
+                                   to_string(m_status), to_string(aStatus));
+                }
+                for (const auto& cb : m_onLeavingCallbacks[static_cast<size_t>(m_status)])
                 {
-                    cb(m_status, aDataAccess, aSharedData, aProgressData);
+                    cb(aDataAccess, aSharedData, aProgressData);
                 }
-                for (const auto& cb : m_onEnteringCallbacks)
+                for (const auto& cb : m_onEnteringCallbacks[static_cast<size_t>(aStatus)])
                 {
-                    cb(aStatus, aDataAccess, aSharedData, aProgressData);
+                    cb(aDataAccess, aSharedData, aProgressData);
                 }
                 SetStatus(aStatus);
             }
@@ -325,8 +447,7 @@ namespace GE
                 return m_onStatusChangedCallback.Add(aCallback);
             }
 
-            PMA::ScopedTokenPtr OnProgressMade(
-                const std::function<void(const std::unordered_set<ProgressTracker*>&)>& aCallback) override
+            PMA::ScopedTokenPtr OnProgressMade(const std::function<void(std::span<ProgressTracker* const>)>& aCallback) override
             {
                 return m_onProgressMadeCallback.Add(aCallback);
             }
@@ -337,9 +458,9 @@ namespace GE
              */
             const Metadata& GetMetadata() const override { return m_metadata; }
 
-            const std::unordered_set<ProgressTracker*>& GetProgress(ConditionType aConditionType) const override
+            std::span<ProgressTracker* const> GetProgress(ConditionType aConditionType) const override
             {
-                return m_progressTrackers.at(aConditionType);
+                return m_conditions.Get(aConditionType);
             }
 
             void Serialize(BinWriter aOut) const override
@@ -358,6 +479,7 @@ namespace GE
                 if constexpr (std::is_base_of_v<PersistentData, ProgressData>)
                 {
                     m_progressData.Deserialize(aIn);
+                    m_conditions.Recount();
                 }
             }
         };
@@ -370,31 +492,17 @@ namespace GE
         static_assert(std::is_default_constructible_v<ProgressData>, "ProgressData has to be default constructible");
 
         Metadata m_metadata;
-        std::function<void(ProgressData&, std::unordered_map<ConditionType, std::unordered_set<ProgressTracker*>>&)>
-            m_conditionsSetup;
+        std::function<void(ProgressData&, ConditionTrackers&)> m_conditionsSetup;
 
-        std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> m_onEnteringCallbacks;
-        std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> m_onLeavingCallbacks;
-        std::vector<std::function<void(Status, const DataAccess&, const SharedData&, ProgressData&)>> m_updateCallbacks;
-
-        auto StatusWrapper(Status aStatus,
-                           const std::function<void(const DataAccess&, const SharedData&, ProgressData&)>& aCallback)
-        {
-            return [aStatus, aCallback](Status status, const DataAccess& dataAccess, const SharedData& sharedData,
-                                        ProgressData& progressData) {
-                if (status != aStatus)
-                {
-                    return;
-                }
-                aCallback(dataAccess, sharedData, progressData);
-            };
-        }
+        StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> m_onEnteringCallbacks;
+        StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> m_onLeavingCallbacks;
+        StatusCallbacks<const DataAccess&, const SharedData&, ProgressData&> m_updateCallbacks;
+        std::vector<Dependency> m_dependencies;
 
     public:
         AchievementBuilder(
             Metadata aMetadata,
-            std::function<void(ProgressData&, std::unordered_map<ConditionType, std::unordered_set<ProgressTracker*>>&)>
-                aConditionsSetup)
+            std::function<void(ProgressData&, ConditionTrackers&)> aConditionsSetup)
             : m_metadata(std::move(aMetadata))
             , m_conditionsSetup(std::move(aConditionsSetup))
         {
@@ -405,30 +513,44 @@ namespace GE
             if (!aLogger)
             {
                 aLogger = std::make_shared<spdlog::logger>("empty");
+                aLogger->set_level(spdlog::level::off);
             }
             return std::make_unique<details::AchievementImpl<Metadata, ProgressData, SharedData, DataAccess>>(
                 std::move(m_metadata), std::move(m_conditionsSetup), std::move(m_updateCallbacks),
-                std::move(m_onEnteringCallbacks), std::move(m_onLeavingCallbacks), std::move(aLogger));
+                std::move(m_onEnteringCallbacks), std::move(m_onLeavingCallbacks), std::move(m_dependencies),
+                std::move(aLogger));
         }
 
         AchievementBuilder& OnEntering(Status aStatus,
                                        const std::function<void(const DataAccess&, const SharedData&, ProgressData&)>& aCallback)
         {
-            m_onEnteringCallbacks.push_back(StatusWrapper(aStatus, aCallback));
+            m_onEnteringCallbacks.at(static_cast<size_t>(aStatus)).push_back(aCallback);
             return *this;
         }
 
         AchievementBuilder& OnLeaving(Status aStatus,
                                       const std::function<void(const DataAccess&, const SharedData&, ProgressData&)>& aCallback)
         {
-            m_onLeavingCallbacks.push_back(StatusWrapper(aStatus, aCallback));
+            m_onLeavingCallbacks.at(static_cast<size_t>(aStatus)).push_back(aCallback);
             return *this;
         }
 
         AchievementBuilder& Update(Status aStatus,
                                    const std::function<void(const DataAccess&, const SharedData&, ProgressData&)>& aCallback)
         {
-            m_updateCallbacks.push_back(StatusWrapper(aStatus, aCallback));
+            m_updateCallbacks.at(static_cast<size_t>(aStatus)).push_back(aCallback);
+            return *this;
+        }
+
+        /*
+         * Declares aSize bytes at aOffset of layout aLayout as read by the update callbacks, aSize 0 declares the whole layout.
+         * AchievementManager updates an achievement with dependencies only in frames in which some of them changed, or when
+         * the achievement is due for other reasons, see Achievement::IsUpdateDue. Callbacks which make progress without any
+         * data change, e.g. counting frames, must not be used on achievements with dependencies.
+         */
+        AchievementBuilder& DependsOn(std::string aLayout, size_t aOffset = 0, size_t aSize = 0)
+        {
+            m_dependencies.push_back({std::move(aLayout), aOffset, aSize});
             return *this;
         }
     };
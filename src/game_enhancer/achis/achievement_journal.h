@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "spdlog/spdlog.h"
+
+namespace GE
+{
+    struct AchievementJournal;
+    using AchievementJournalPtr = std::unique_ptr<AchievementJournal>;
+
+    /*
+     * Append-only log of serialized achievement states, see AchievementManager::EnableJournal.
+     * The file is a sequence of records, each with a CRC-32: checkpoints with the states of all achievements and deltas
+     * with the new state of one achievement. Reading stops at the first damaged record, e.g. one torn by a crash.
+     * Once the deltas after the last checkpoint reach aCompactAfter bytes, the journal is rewritten as one checkpoint on
+     * a background thread while deltas keep being appended. The rewritten file is synced to the disk before it replaces
+     * the journal by a rename, so a crash leaves either journal intact (on Linux, elsewhere only the rename is atomic).
+     * After a failed compaction the next one waits for another aCompactAfter bytes of deltas.
+     */
+    struct AchievementJournal
+    {
+        // Serialized state by achievement id
+        using States = std::map<uint32_t, std::string>;
+
+        virtual ~AchievementJournal() = default;
+
+        [[nodiscard]] static AchievementJournalPtr Create(std::filesystem::path aPath, size_t aCompactAfter,
+                                                          std::shared_ptr<spdlog::logger> aLogger);
+
+        /*
+         * Latest state of every achievement in the journal at aPath, empty when there is no journal.
+         */
+        [[nodiscard]] static States Read(const std::filesystem::path& aPath);
+
+        /*
+         * Replaces the journal with a single checkpoint of aStates, drops unwritten deltas.
+         * Has to be called before the first Append.
+         */
+        virtual void WriteCheckpoint(const States& aStates) = 0;
+
+        /*
+         * Buffers a delta until the next Flush.
+         */
+        virtual void Append(uint32_t aId, std::string_view aState) = 0;
+
+        /*
+         * Writes buffered deltas with a single write, takes over a finished compaction and starts a new one when due.
+         */
+        virtual void Flush() = 0;
+
+        /*
+         * Waits for a running compaction and takes it over.
+         */
+        virtual void WaitForCompaction() = 0;
+
+        virtual bool IsCompacting() const = 0;
+
+        /*
+         * Bytes of deltas written after the last checkpoint.
+         */
+        virtual uint64_t GetTailSize() const = 0;
+    };
+}
@@ -1,11 +1,27 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <map>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "game_enhancer/achis/achievement.h"
+#include "game_enhancer/achis/achievement_journal.h"
+#include "game_enhancer/achis/save_writer.h"
+#include "game_enhancer/achis/update_pool.h"
+#include "game_enhancer/data_accessor.h"
+#include "game_enhancer/log.h"
+#include "game_enhancer/tracer.h"
 #include "spdlog/spdlog.h"
 
 namespace GE
@@ -19,8 +35,238 @@ namespace GE
 
         std::map<uint32_t, std::unique_ptr<AchievementType>> m_activeAchievements;
 
+        /*
+         * Achievement with dependencies reading aSize bytes at aOffset of a layout, aSize 0 for the whole layout.
+         * m_order is the position of the achievement in id order.
+         */
+        struct Dependent
+        {
+            size_t m_order = 0;
+            size_t m_offset = 0;
+            size_t m_size = 0;
+        };
+
+        // Active achievements in id order, the index refers to them by position
+        std::vector<AchievementType*> m_ordered;
+        std::vector<uint32_t> m_orderedIds;
+        std::vector<size_t> m_alwaysUpdated;
+        std::vector<size_t> m_indexed;
+        std::unordered_map<std::string, std::vector<Dependent>> m_dependents;
+        std::optional<size_t> m_lastSequence;
+        std::vector<size_t> m_due;
+        std::vector<bool> m_scheduled;
+        std::vector<AchievementType*> m_batch;
+
+        UpdatePoolPtr m_updatePool;
+        size_t m_chunkSize = 64;
+        // One queue per chunk of m_due, delivered in chunk order
+        std::vector<NotificationQueue> m_notifications;
+
+        AchievementJournalPtr m_journal;
+        std::vector<PMA::ScopedTokenPtr> m_journalTokens;
+        // Ids of achievements whose status or trackers changed since the last journal flush
+        std::vector<uint32_t> m_journalChanged;
+
+        SaveWriterPtr m_saveWriter;
+
         std::shared_ptr<spdlog::logger> m_logger;
 
+        std::filesystem::path GetJournalPath(const std::string& aId) const { return m_pathToStorage / (aId + ".journal"); }
+
+        void SerializeAll(BinWriter aOut) const
+        {
+            for (const auto& [id, achievement] : m_activeAchievements)
+            {
+                aOut.Write(id);
+                achievement->Serialize(aOut);
+            }
+        }
+
+        static std::string SerializeState(const AchievementType& aAchievement)
+        {
+            std::ostringstream out(std::ios::binary);
+            aAchievement.Serialize(out);
+            return std::move(out).str();
+        }
+
+        /*
+         * Writes a checkpoint of the active achievements and starts listening to their changes.
+         */
+        void StartJournal()
+        {
+            if (!m_journal || m_activeAchievements.empty())
+            {
+                return;
+            }
+            AchievementJournal::States states;
+            for (const auto& [id, achievement] : m_activeAchievements)
+            {
+                states[id] = SerializeState(*achievement);
+                // Part of the checkpoint
+                achievement->TakeProgressChanged();
+                m_journalTokens.push_back(achievement->OnStatusChanged([this, id](Status, Status) {
+                    m_journalChanged.push_back(id);
+                }));
+            }
+            m_journal->WriteCheckpoint(states);
+        }
+
+        void StopJournal()
+        {
+            FlushJournal();
+            m_journalTokens.clear();
+            m_journalChanged.clear();
+        }
+
+        void FlushJournal()
+        {
+            if (!m_journal)
+            {
+                return;
+            }
+            // Tracker changes are taken at the source, OnProgressMade misses those made while preconditions are unmet
+            for (auto order : m_due)
+            {
+                if (m_ordered[order]->TakeProgressChanged())
+                {
+                    m_journalChanged.push_back(m_orderedIds[order]);
+                }
+            }
+            if (m_journalChanged.empty())
+            {
+                return;
+            }
+            std::ranges::sort(m_journalChanged);
+            m_journalChanged.erase(std::ranges::unique(m_journalChanged).begin(), m_journalChanged.end());
+            for (auto id : m_journalChanged)
+            {
+                m_journal->Append(id, SerializeState(*m_activeAchievements.at(id)));
+            }
+            m_journalChanged.clear();
+            m_journal->Flush();
+        }
+
+        void BuildIndex()
+        {
+            m_ordered.clear();
+            m_orderedIds.clear();
+            m_due.clear();
+            m_alwaysUpdated.clear();
+            m_indexed.clear();
+            m_dependents.clear();
+            m_lastSequence.reset();
+            for (auto& [id, achievement] : m_activeAchievements)
+            {
+                auto order = m_ordered.size();
+                m_ordered.push_back(achievement.get());
+                m_orderedIds.push_back(id);
+                const auto& dependencies = achievement->GetDependencies();
+                (dependencies.empty() ? m_alwaysUpdated : m_indexed).push_back(order);
+                for (const auto& dependency : dependencies)
+                {
+                    m_dependents[dependency.m_layout].push_back({order, dependency.m_offset, dependency.m_size});
+                }
+            }
+        }
+
+        /*
+         * Collects achievements to update in this frame, in id order: those without dependencies, those whose dependencies
+         * changed since the last update and those due for other reasons. Everything is due when frames were read in between
+         * the updates, changes are known only against the frame right before.
+         */
+        void CollectDue(const typename AchievementType::_DataAccess& aDataAccess)
+        {
+            m_due.clear();
+            m_scheduled.assign(m_ordered.size(), false);
+            auto schedule = [this](size_t aOrder) {
+                if (!m_scheduled[aOrder])
+                {
+                    m_scheduled[aOrder] = true;
+                    m_due.push_back(aOrder);
+                }
+            };
+            for (auto order : m_alwaysUpdated)
+            {
+                schedule(order);
+            }
+            if (m_indexed.empty())
+            {
+                return;
+            }
+
+            bool sameFrame = false;
+            bool nextFrame = false;
+            if constexpr (std::derived_from<typename AchievementType::_DataAccess, DataAccessor>)
+            {
+                auto sequence = aDataAccess.GetSequence();
+                sameFrame = m_lastSequence == sequence;
+                nextFrame = m_lastSequence && aDataAccess.GetNumberOfFrames() > 1 &&
+                            aDataAccess.GetSequence(1) == *m_lastSequence && *m_lastSequence + 1 == sequence;
+                m_lastSequence = sequence;
+                if (nextFrame)
+                {
+                    for (const auto& [layout, dependents] : m_dependents)
+                    {
+                        const auto* current = aDataAccess.GetRaw(layout);
+                        const auto* previous = aDataAccess.GetRaw(layout, 1);
+                        // Unchanged objects are shared with the previous frame, including their whole subtree
+                        if (current == previous)
+                        {
+                            continue;
+                        }
+                        for (const auto& dependent : dependents)
+                        {
+                            if (!current || !previous || dependent.m_size == 0 ||
+                                aDataAccess.HasChanged(current, dependent.m_offset, dependent.m_size))
+                            {
+                                schedule(dependent.m_order);
+                            }
+                        }
+                    }
+                }
+            }
+            for (auto order : m_indexed)
+            {
+                if (!(sameFrame || nextFrame) || m_ordered[order]->IsUpdateDue())
+                {
+                    schedule(order);
+                }
+            }
+            std::ranges::sort(m_due);
+        }
+
+        void UpdateParallel(const typename AchievementType::_DataAccess& aDataAccess,
+                            const typename AchievementType::_SharedData& aSharedData)
+        {
+            auto chunks = (m_due.size() + m_chunkSize - 1) / m_chunkSize;
+            m_notifications.resize(chunks);
+            std::exception_ptr error;
+            try
+            {
+                m_updatePool->Run(chunks, [&](size_t aChunk) {
+                    NotificationQueue::Scope scope(m_notifications[aChunk]);
+                    auto end = std::min(m_due.size(), (aChunk + 1) * m_chunkSize);
+                    for (auto i = aChunk * m_chunkSize; i < end; ++i)
+                    {
+                        m_ordered[m_due[i]]->Update(aDataAccess, aSharedData);
+                    }
+                });
+            }
+            catch (...)
+            {
+                // Progress made before the failure is still reported, as it would be in serial mode
+                error = std::current_exception();
+            }
+            for (size_t i = 0; i < chunks; ++i)
+            {
+                m_notifications[i].Deliver();
+            }
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
     public:
         AchievementManager(std::function<std::map<uint32_t, std::unique_ptr<AchievementType>>()> aAchievementCreator,
                            std::filesystem::path aPathToStorage, std::shared_ptr<spdlog::logger> aLogger)
@@ -41,6 +287,8 @@ namespace GE
             Deactivate();
             m_logger->info("New achievements activated");
             m_activeAchievements = std::move(aAchievements);
+            BuildIndex();
+            StartJournal();
         }
 
         /*
@@ -49,21 +297,59 @@ namespace GE
         void Deactivate()
         {
             m_logger->info("Achievements deactivated");
+            StopJournal();
             m_activeAchievements.clear();
+            BuildIndex();
         }
 
         /*
          * Applies to the current active set of achievements.
+         * Achievements with dependencies are updated only when they changed, see AchievementBuilder::DependsOn.
+         * Should be called for every frame, otherwise all achievements are updated on the next call.
          */
         void Update(const typename AchievementType::_DataAccess& aDataAccess,
                     const typename AchievementType::_SharedData& aSharedData)
         {
-            m_logger->trace("Updating achievements");
-            for (auto& [_, achievement] : m_activeAchievements)
+            GE_LOG_TRACE(m_logger, "Updating achievements");
+            TraceSpan span("AchievementUpdate");
+            CollectDue(aDataAccess);
+            if constexpr (requires { AchievementType::UpdateBatch(m_batch, aDataAccess, aSharedData); })
+            {
+                // Achievements sharing their state are updated together, e.g. StoredAchievement
+                m_batch.clear();
+                for (auto order : m_due)
+                {
+                    m_batch.push_back(m_ordered[order]);
+                }
+                AchievementType::UpdateBatch(m_batch, aDataAccess, aSharedData);
+            }
+            else if (m_updatePool && m_due.size() > m_chunkSize)
             {
-                achievement->Update(aDataAccess, aSharedData);
+                UpdateParallel(aDataAccess, aSharedData);
             }
-            m_logger->trace("Finished updating achievements");
+            else
+            {
+                for (auto order : m_due)
+                {
+                    m_ordered[order]->Update(aDataAccess, aSharedData);
+                }
+            }
+            FlushJournal();
+            GE_LOG_TRACE(m_logger, "Finished updating {} of {} achievements", m_due.size(), m_ordered.size());
+        }
+
+        /*
+         * Updates achievements on aWorkers threads, 0 switches back to updating on the calling thread.
+         * Achievements are split into chunks of aChunkSize consecutive ids. Status and progress notifications are queued per
+         * chunk and delivered on the calling thread once all updates finished, in id order, the same order as in serial mode.
+         * Update, entering and leaving callbacks run on the workers, they may modify only their own ProgressData.
+         * Has no effect on achievement types updated in batches, see StoredAchievement.
+         */
+        void SetParallelUpdate(size_t aWorkers, size_t aChunkSize = 64)
+        {
+            m_logger->info("Parallel achievement updates: {} workers, chunks of {}", aWorkers, aChunkSize);
+            m_updatePool = aWorkers ? UpdatePool::Create(aWorkers) : nullptr;
+            m_chunkSize = std::max<size_t>(1, aChunkSize);
         }
 
         const auto& GetActiveAchievements() const { return m_activeAchievements; }
@@ -81,13 +367,48 @@ namespace GE
             {
                 throw std::invalid_argument("Save Id cannot be empty");
             }
+            // A pending asynchronous save must not overwrite this one
+            WaitForSaves();
             auto outStream = std::ofstream(m_pathToStorage / aId, std::ios::binary);
-            BinWriter bw(outStream);
             m_logger->info("Saving achievements progress");
-            for (const auto& [id, achievement] : m_activeAchievements)
+            SerializeAll(outStream);
+        }
+
+        /*
+         * Applies to the current active set of achievements.
+         * Only serializes the achievements into memory on the calling thread, the file is written on a background thread,
+         * see SaveWriter. A save requested before the previous save of the same id started replaces it.
+         */
+        std::shared_future<void> SaveAsync(const std::string& aId)
+        {
+            if (m_activeAchievements.empty())
+            {
+                std::promise<void> done;
+                done.set_value();
+                return done.get_future().share();
+            }
+            if (aId.empty())
+            {
+                throw std::invalid_argument("Save Id cannot be empty");
+            }
+            if (!m_saveWriter)
+            {
+                m_saveWriter = SaveWriter::Create(m_logger);
+            }
+            GE_LOG_TRACE(m_logger, "Saving achievements progress in the background");
+            std::ostringstream snapshot(std::ios::binary);
+            SerializeAll(snapshot);
+            return m_saveWriter->Write(m_pathToStorage / aId, std::move(snapshot).str());
+        }
+
+        /*
+         * Waits for all saves requested by SaveAsync.
+         */
+        void WaitForSaves()
+        {
+            if (m_saveWriter)
             {
-                bw.Write(id);
-                achievement->Serialize(bw);
+                m_saveWriter->Wait();
             }
         }
 
@@ -100,6 +421,7 @@ namespace GE
                 m_logger->info("Using default achievements - no achievements file specified");
                 return loadedAchis;
             }
+            WaitForSaves();
             auto inPath = m_pathToStorage / aId.value();
             if (!std::filesystem::exists(inPath))
             {
@@ -120,6 +442,52 @@ namespace GE
             return loadedAchis;
         }
 
+        /*
+         * Journals progress of the active achievements to aId.journal in the storage directory, see AchievementJournal.
+         * Activation writes a checkpoint of all achievements, every Update appends the states of achievements whose status
+         * or trackers changed, so persisting every frame costs in proportion to the changes. Tracker changes are journaled
+         * even while unmet preconditions hold back their progress notifications. The journal is
+         * replaced on activation, load it with LoadJournal before. Deltas are compacted after aCompactAfter bytes.
+         */
+        void EnableJournal(const std::string& aId, size_t aCompactAfter = 1 << 20)
+        {
+            if (aId.empty())
+            {
+                throw std::invalid_argument("Journal Id cannot be empty");
+            }
+            m_logger->info("Journaling achievements progress to {}", GetJournalPath(aId).string());
+            StopJournal();
+            m_journal = AchievementJournal::Create(GetJournalPath(aId), aCompactAfter, m_logger);
+            StartJournal();
+        }
+
+        void DisableJournal()
+        {
+            StopJournal();
+            m_journal.reset();
+        }
+
+        /*
+         * Replays the last checkpoint and the deltas after it, see EnableJournal.
+         */
+        auto LoadJournal(const std::string& aId)
+        {
+            m_logger->info("Loading achievements progress from journal");
+            auto loadedAchis = m_achievementCreator();
+            auto inPath = GetJournalPath(aId);
+            if (!std::filesystem::exists(inPath))
+            {
+                m_logger->warn("Using default achievements - selected journal does not exist: {}", inPath.string());
+                return loadedAchis;
+            }
+            for (const auto& [id, state] : AchievementJournal::Read(inPath))
+            {
+                std::istringstream inStream(state, std::ios::binary);
+                loadedAchis.at(id)->Deserialize(inStream);
+            }
+            return loadedAchis;
+        }
+
         void LoadAndActivate(std::optional<std::string> aId) { Activate(Load(std::move(aId))); }
     };
 }
@@ -0,0 +1,585 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "game_enhancer/achis/achievement.h"
+#include "game_enhancer/achis/conditions.h"
+#include "game_enhancer/data_accessor.h"
+#include "pma/impl/callback/callback.h"
+#include "spdlog/spdlog.h"
+
+namespace GE
+{
+    template <typename Metadata, typename SharedData, typename DataAccess>
+    class StoredAchievement;
+
+    template <typename Metadata, typename SharedData, typename DataAccess>
+    class AchievementStoreBuilder;
+
+    /*
+     * Achievements of a large pack kept in structure of arrays. Statuses, pause requests, tracker values and targets are
+     * arrays addressed by the index of the achievement or tracker, status transitions are evaluated by scanning them.
+     * Trackers are integers completed when their value reaches the target, the number of completed trackers per condition
+     * type is counted the same way as in ConditionTrackers.
+     *
+     * Achievements are updated by callbacks of the whole store per status, they receive the indices of the achievements due.
+     * Statuses change by the same rules as in AchievementImpl, see Update. Unlike there, stored trackers are not
+     * ProgressTracker objects, progress callbacks get an empty span and StoredAchievement::GetProgress is empty.
+     * Use AchievementStoreBuilder to fill a store, its entries are used with AchievementManager<StoredAchievement<...>>.
+     */
+    template <typename Metadata = None, typename SharedData = None, typename DataAccess = GE::DataAccessor>
+    class AchievementStore
+    {
+    public:
+        using UpdateCallback =
+            std::function<void(AchievementStore&, std::span<const uint32_t>, const DataAccess&, const SharedData&)>;
+        using UpdateCallbacks = StatusCallbacks<AchievementStore&, std::span<const uint32_t>, const DataAccess&, const SharedData&>;
+
+    private:
+        friend class AchievementStoreBuilder<Metadata, SharedData, DataAccess>;
+
+        static constexpr size_t kTypes = static_cast<size_t>(ConditionType::All);
+
+        enum class PauseRequest : uint8_t
+        {
+            None,
+            Pause,
+            Resume,
+        };
+
+        // Per achievement
+        std::vector<uint32_t> m_ids;
+        std::vector<Metadata> m_metadata;
+        std::vector<Status> m_status;
+        std::vector<Status> m_prePauseStatus;
+        std::vector<std::atomic<PauseRequest>> m_pauseRequests;
+        std::vector<uint8_t> m_progressed;
+        // Trackers changed since the last TakeProgressChanged
+        std::vector<uint8_t> m_progressChanged;
+        // Trackers of achievement i are [m_firstTracker[i], m_firstTracker[i + 1])
+        std::vector<uint32_t> m_firstTracker{0};
+        std::array<std::vector<uint16_t>, kTypes> m_trackers;
+        std::array<std::vector<uint16_t>, kTypes> m_completed;
+
+        // Per tracker
+        std::vector<int64_t> m_current;
+        std::vector<int64_t> m_initial;
+        std::vector<int64_t> m_target;
+        std::vector<ConditionType> m_trackerType;
+        std::vector<uint32_t> m_owner;
+
+        UpdateCallbacks m_updateCallbacks;
+        // Only achievements somebody listens to have callbacks
+        std::unordered_map<uint32_t, PMA::Callback<Status, Status>> m_statusCallbacks;
+        std::unordered_map<uint32_t, PMA::Callback<std::span<ProgressTracker* const>>> m_progressCallbacks;
+
+        std::shared_ptr<spdlog::logger> m_logger;
+        // Achievements of the running update per status, Status::All holds all of them but the paused ones
+        std::array<std::vector<uint32_t>, static_cast<size_t>(Status::All) + 1> m_due;
+        // Due achievements with all preconditions completed
+        std::vector<uint32_t> m_gated;
+
+        AchievementStore() = default;
+
+        bool IsCompleted(uint32_t aTracker) const { return m_current[aTracker] >= m_target[aTracker]; }
+
+        bool AllCompleted(ConditionType aConditionType, uint32_t aIndex) const
+        {
+            auto type = static_cast<size_t>(aConditionType);
+            return m_completed[type][aIndex] == m_trackers[type][aIndex];
+        }
+
+        bool AnyCompleted(ConditionType aConditionType, uint32_t aIndex) const
+        {
+            return m_completed[static_cast<size_t>(aConditionType)][aIndex] > 0;
+        }
+
+        void Recount(uint32_t aIndex)
+        {
+            for (auto& completed : m_completed)
+            {
+                completed[aIndex] = 0;
+            }
+            for (auto tracker = m_firstTracker[aIndex]; tracker < m_firstTracker[aIndex + 1]; ++tracker)
+            {
+                m_completed[static_cast<size_t>(m_trackerType[tracker])][aIndex] += IsCompleted(tracker) ? 1 : 0;
+            }
+        }
+
+        void ResetTrackers(uint32_t aIndex)
+        {
+            for (auto tracker = m_firstTracker[aIndex]; tracker < m_firstTracker[aIndex + 1]; ++tracker)
+            {
+                m_current[tracker] = m_initial[tracker];
+            }
+            m_progressChanged[aIndex] = 1;
+            Recount(aIndex);
+        }
+
+        /*
+         * Status change without logging, as restored by Deserialize.
+         */
+        void ApplyStatus(uint32_t aIndex, Status aStatus)
+        {
+            auto oldStatus = std::exchange(m_status[aIndex], aStatus);
+            if (oldStatus == aStatus)
+            {
+                return;
+            }
+            if (auto callback = m_statusCallbacks.find(aIndex); callback != m_statusCallbacks.end())
+            {
+                callback->second(aStatus, oldStatus);
+            }
+        }
+
+        void ProcessPause(std::span<const uint32_t> aIndices)
+        {
+            for (auto index : aIndices)
+            {
+                auto request = m_pauseRequests[index].exchange(PauseRequest::None, std::memory_order_relaxed);
+                if (request == PauseRequest::Pause && m_status[index] != Status::Paused)
+                {
+                    m_prePauseStatus[index] = m_status[index];
+                    SetStatus(index, Status::Paused);
+                }
+                else if (request == PauseRequest::Resume && m_status[index] == Status::Paused)
+                {
+                    SetStatus(index, m_prePauseStatus[index]);
+                }
+            }
+        }
+
+        void RunUpdateForStatus(Status aStatus, const DataAccess& aDataAccess, const SharedData& aSharedData)
+        {
+            const auto& due = m_due[static_cast<size_t>(aStatus)];
+            if (due.empty())
+            {
+                return;
+            }
+            for (const auto& callback : m_updateCallbacks[static_cast<size_t>(aStatus)])
+            {
+                callback(*this, due, aDataAccess, aSharedData);
+            }
+        }
+
+        /*
+         * Transitions of achievements with completed preconditions which made progress since their last transition.
+         */
+        void ProcessTransitions(std::span<const uint32_t> aIndices)
+        {
+            for (auto index : aIndices)
+            {
+                if (!m_progressed[index])
+                {
+                    continue;
+                }
+                m_progressed[index] = 0;
+                if (auto callback = m_progressCallbacks.find(index); callback != m_progressCallbacks.end())
+                {
+                    callback->second({});
+                }
+                switch (m_status[index])
+                {
+                case Status::Inactive:
+                    if (AllCompleted(ConditionType::Activator, index))
+                    {
+                        SetStatus(index, Status::Active);
+                    }
+                    break;
+                case Status::Active:
+                    if (AllCompleted(ConditionType::Completer, index))
+                    {
+                        SetStatus(index, AllCompleted(ConditionType::Validator, index) ? Status::Completed : Status::Failed);
+                    }
+                    else if (AnyCompleted(ConditionType::Failer, index))
+                    {
+                        SetStatus(index, Status::Failed);
+                    }
+                    break;
+                case Status::Failed:
+                    if (AllCompleted(ConditionType::Reseter, index))
+                    {
+                        SetStatus(index, Status::Inactive);
+                        ResetTrackers(index);
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+    public:
+        AchievementStore(const AchievementStore&) = delete;
+        AchievementStore& operator=(const AchievementStore&) = delete;
+
+        size_t GetSize() const { return m_status.size(); }
+
+        uint32_t GetId(uint32_t aIndex) const { return m_ids.at(aIndex); }
+
+        const Metadata& GetMetadata(uint32_t aIndex) const { return m_metadata.at(aIndex); }
+
+        Status GetStatus(uint32_t aIndex) const { return m_status.at(aIndex); }
+
+        /*
+         * Tracker indices of the achievement at aIndex, in the order they were added.
+         */
+        std::pair<uint32_t, uint32_t> GetTrackers(uint32_t aIndex) const
+        {
+            return {m_firstTracker.at(aIndex), m_firstTracker.at(aIndex + 1)};
+        }
+
+        int64_t GetCurrent(uint32_t aTracker) const { return m_current.at(aTracker); }
+
+        int64_t GetTarget(uint32_t aTracker) const { return m_target.at(aTracker); }
+
+        void SetCurrent(uint32_t aTracker, int64_t aCurrent)
+        {
+            auto& current = m_current.at(aTracker);
+            if (current == aCurrent)
+            {
+                return;
+            }
+            bool wasCompleted = IsCompleted(aTracker);
+            current = aCurrent;
+            auto owner = m_owner[aTracker];
+            m_progressed[owner] = 1;
+            m_progressChanged[owner] = 1;
+            if (IsCompleted(aTracker) != wasCompleted)
+            {
+                auto& completed = m_completed[static_cast<size_t>(m_trackerType[aTracker])][owner];
+                wasCompleted ? --completed : ++completed;
+            }
+        }
+
+        void AddCurrent(uint32_t aTracker, int64_t aDelta) { SetCurrent(aTracker, GetCurrent(aTracker) + aDelta); }
+
+        /*
+         * Changes the status right away, runs status callbacks on the calling thread.
+         */
+        void SetStatus(uint32_t aIndex, Status aStatus)
+        {
+            auto oldStatus = m_status.at(aIndex);
+            if (oldStatus == aStatus)
+            {
+                return;
+            }
+            if (m_logger->should_log(spdlog::level::info))
+            {
+                m_logger->info("Achievement {} leaving status '{}', entering status '{}'", m_ids[aIndex], to_string(oldStatus),
+                               to_string(aStatus));
+            }
+            ApplyStatus(aIndex, aStatus);
+        }
+
+        void Pause(uint32_t aIndex, bool aPause)
+        {
+            auto status = m_status.at(aIndex);
+            if (status == Status::Disabled || status == Status::Completed)
+            {
+                return;
+            }
+            m_pauseRequests[aIndex].store(aPause ? PauseRequest::Pause : PauseRequest::Resume, std::memory_order_relaxed);
+        }
+
+        /*
+         * True when trackers of the achievement at aIndex changed since the last call, see Achievement::TakeProgressChanged.
+         */
+        bool TakeProgressChanged(uint32_t aIndex) { return std::exchange(m_progressChanged.at(aIndex), uint8_t{0}) != 0; }
+
+        bool IsPauseRequested(uint32_t aIndex) const
+        {
+            return m_pauseRequests.at(aIndex).load(std::memory_order_relaxed) != PauseRequest::None;
+        }
+
+        /*
+         * Updates the achievements at aIndices, all of them when empty, by the rules of AchievementImpl::Update. Disabled
+         * and completed achievements are skipped, paused ones get only the Status::Paused callbacks. The others get the
+         * Status::All callbacks, then those with all preconditions completed get the callbacks of their status and change
+         * their status by the rules of ConditionType when they made progress. Progress of the others is kept until their
+         * preconditions are completed.
+         */
+        void Update(std::span<const uint32_t> aIndices, const DataAccess& aDataAccess, const SharedData& aSharedData)
+        {
+            std::vector<uint32_t> all;
+            if (aIndices.empty())
+            {
+                all.resize(GetSize());
+                std::iota(all.begin(), all.end(), uint32_t{0});
+                aIndices = all;
+            }
+            ProcessPause(aIndices);
+            for (auto& due : m_due)
+            {
+                due.clear();
+            }
+            for (auto index : aIndices)
+            {
+                auto status = m_status[index];
+                if (status != Status::Disabled && status != Status::Completed)
+                {
+                    m_due[static_cast<size_t>(status == Status::Paused ? Status::Paused : Status::All)].push_back(index);
+                }
+            }
+            RunUpdateForStatus(Status::Paused, aDataAccess, aSharedData);
+            RunUpdateForStatus(Status::All, aDataAccess, aSharedData);
+
+            m_gated.clear();
+            for (auto index : m_due[static_cast<size_t>(Status::All)])
+            {
+                if (AllCompleted(ConditionType::Precondition, index))
+                {
+                    m_gated.push_back(index);
+                    m_due[static_cast<size_t>(m_status[index])].push_back(index);
+                }
+            }
+            for (auto status : {Status::Inactive, Status::Active, Status::Failed})
+            {
+                RunUpdateForStatus(status, aDataAccess, aSharedData);
+            }
+            ProcessTransitions(m_gated);
+        }
+
+        PMA::ScopedTokenPtr OnStatusChanged(uint32_t aIndex, const std::function<void(Status, Status)>& aCallback)
+        {
+            return m_statusCallbacks[aIndex].Add(aCallback);
+        }
+
+        /*
+         * Called when trackers of the achievement changed, stored trackers are not ProgressTracker objects and the span is
+         * always empty.
+         */
+        PMA::ScopedTokenPtr OnProgressMade(uint32_t aIndex,
+                                           const std::function<void(std::span<ProgressTracker* const>)>& aCallback)
+        {
+            return m_progressCallbacks[aIndex].Add(aCallback);
+        }
+
+        void Serialize(uint32_t aIndex, BinWriter aOut) const
+        {
+            aOut.Write(m_status.at(aIndex) == Status::Completed);
+            auto [first, last] = GetTrackers(aIndex);
+            aOut.Write(last - first);
+            aOut.Write(m_current.data() + first, (last - first) * sizeof(int64_t));
+        }
+
+        void Deserialize(uint32_t aIndex, BinReader aIn)
+        {
+            bool completed = aIn.Read<bool>();
+            ApplyStatus(aIndex, completed ? Status::Completed : Status::Inactive);
+            auto [first, last] = GetTrackers(aIndex);
+            auto count = aIn.Read<uint32_t>();
+            if (count != last - first)
+            {
+                throw std::runtime_error(
+                    std::format("Achievement {} has {} trackers, saved progress has {}", m_ids[aIndex], last - first, count));
+            }
+            aIn.Read(m_current.data() + first, count * sizeof(int64_t));
+            Recount(aIndex);
+        }
+    };
+
+    /*
+     * Entry of an AchievementStore. Holds only the store and an index, all state lives in the store.
+     * AchievementManager updates all due entries of a store with a single AchievementStore::Update, see UpdateBatch.
+     */
+    template <typename Metadata = None, typename SharedData = None, typename DataAccess = GE::DataAccessor>
+    class StoredAchievement : public Achievement<Metadata, SharedData, DataAccess>
+    {
+        using Store = AchievementStore<Metadata, SharedData, DataAccess>;
+
+        std::shared_ptr<Store> m_store;
+        uint32_t m_index;
+
+        inline static const std::vector<Dependency> s_noDependencies;
+
+    public:
+        StoredAchievement(std::shared_ptr<Store> aStore, uint32_t aIndex)
+            : m_store(std::move(aStore))
+            , m_index(aIndex)
+        {
+        }
+
+        /*
+         * Groups aAchievements by store, keeping their order, and updates every store once.
+         */
+        static void UpdateBatch(std::span<StoredAchievement* const> aAchievements, const DataAccess& aDataAccess,
+                                const SharedData& aSharedData)
+        {
+            std::vector<std::pair<Store*, std::vector<uint32_t>>> batches;
+            for (const auto* achievement : aAchievements)
+            {
+                auto batch = std::ranges::find(batches, achievement->m_store.get(), &decltype(batches)::value_type::first);
+                if (batch == batches.end())
+                {
+                    batch = batches.insert(batches.end(), {achievement->m_store.get(), {}});
+                }
+                batch->second.push_back(achievement->m_index);
+            }
+            for (auto& [store, indices] : batches)
+            {
+                store->Update(indices, aDataAccess, aSharedData);
+            }
+        }
+
+        Store& GetStore() const { return *m_store; }
+
+        uint32_t GetIndex() const { return m_index; }
+
+        Status GetStatus() const override { return m_store->GetStatus(m_index); }
+
+        void Update(const DataAccess& aDataAccess, const SharedData& aSharedData) override
+        {
+            m_store->Update(std::span(&m_index, 1), aDataAccess, aSharedData);
+        }
+
+        void Pause(bool aPause) override { m_store->Pause(m_index, aPause); }
+
+        PMA::ScopedTokenPtr OnStatusChanged(const std::function<void(Status, Status)>& aCallback) override
+        {
+            return m_store->OnStatusChanged(m_index, aCallback);
+        }
+
+        PMA::ScopedTokenPtr OnProgressMade(const std::function<void(std::span<ProgressTracker* const>)>& aCallback) override
+        {
+            return m_store->OnProgressMade(m_index, aCallback);
+        }
+
+        const Metadata& GetMetadata() const override { return m_store->GetMetadata(m_index); }
+
+        /*
+         * Stored trackers are not ProgressTracker objects, see AchievementStore::GetTrackers.
+         */
+        std::span<ProgressTracker* const> GetProgress(ConditionType) const override { return {}; }
+
+        const std::vector<Dependency>& GetDependencies() const override { return s_noDependencies; }
+
+        bool IsUpdateDue() const override { return m_store->IsPauseRequested(m_index); }
+
+        bool TakeProgressChanged() override { return m_store->TakeProgressChanged(m_index); }
+
+        void Serialize(BinWriter aOut) const override { m_store->Serialize(m_index, aOut); }
+
+        void Deserialize(BinReader aIn) override { m_store->Deserialize(m_index, aIn); }
+    };
+
+    template <typename Metadata = None, typename SharedData = None, typename DataAccess = GE::DataAccessor>
+    class AchievementStoreBuilder
+    {
+        using Store = AchievementStore<Metadata, SharedData, DataAccess>;
+
+        std::shared_ptr<Store> m_store{new Store()};
+
+    public:
+        /*
+         * Adds an achievement, trackers added afterwards belong to it. Returns its index.
+         */
+        uint32_t Add(uint32_t aId, Metadata aMetadata)
+        {
+            auto& store = *m_store;
+            auto index = static_cast<uint32_t>(store.m_ids.size());
+            store.m_ids.push_back(aId);
+            store.m_metadata.push_back(std::move(aMetadata));
+            store.m_firstTracker.push_back(store.m_firstTracker.back());
+            for (auto& trackers : store.m_trackers)
+            {
+                trackers.push_back(0);
+            }
+            return index;
+        }
+
+        /*
+         * Adds a tracker of aConditionType to the last added achievement, completed when its value reaches aTarget.
+         * Returns the tracker index.
+         */
+        uint32_t AddTracker(ConditionType aConditionType, int64_t aTarget, int64_t aInitial = 0)
+        {
+            auto& store = *m_store;
+            if (store.m_ids.empty())
+            {
+                throw std::runtime_error("Tracker has to be added after its achievement");
+            }
+            auto type = static_cast<size_t>(aConditionType);
+            if (type >= Store::kTypes)
+            {
+                throw std::invalid_argument(std::format("Invalid condition type {}", type));
+            }
+            auto& count = store.m_trackers[type].back();
+            if (count == std::numeric_limits<uint16_t>::max())
+            {
+                throw std::runtime_error(std::format("Too many trackers of achievement {}", store.m_ids.back()));
+            }
+            ++count;
+            auto tracker = store.m_firstTracker.back()++;
+            store.m_current.push_back(aInitial);
+            store.m_initial.push_back(aInitial);
+            store.m_target.push_back(aTarget);
+            store.m_trackerType.push_back(aConditionType);
+            store.m_owner.push_back(static_cast<uint32_t>(store.m_ids.size() - 1));
+            return tracker;
+        }
+
+        /*
+         * Adds a callback for the due achievements of aStatus, see AchievementStore::Update.
+         */
+        AchievementStoreBuilder& Update(Status aStatus, typename Store::UpdateCallback aCallback)
+        {
+            m_store->m_updateCallbacks.at(static_cast<size_t>(aStatus)).push_back(std::move(aCallback));
+            return *this;
+        }
+
+        AchievementStoreBuilder& Update(typename Store::UpdateCallback aCallback)
+        {
+            return Update(Status::All, std::move(aCallback));
+        }
+
+        /*
+         * Entries of all added achievements by id, ready for AchievementManager::Activate.
+         */
+        std::map<uint32_t, std::unique_ptr<StoredAchievement<Metadata, SharedData, DataAccess>>> Build(
+            std::shared_ptr<spdlog::logger> aLogger = {})
+        {
+            if (!aLogger)
+            {
+                aLogger = std::make_shared<spdlog::logger>("empty");
+                aLogger->set_level(spdlog::level::off);
+            }
+            auto store = std::exchange(m_store, std::shared_ptr<Store>(new Store()));
+            auto size = store->m_ids.size();
+            store->m_logger = std::move(aLogger);
+            store->m_status.assign(size, Status::Inactive);
+            store->m_prePauseStatus.assign(size, Status::Inactive);
+            store->m_pauseRequests = std::vector<std::atomic<typename Store::PauseRequest>>(size);
+            store->m_progressed.assign(size, 0);
+            store->m_progressChanged.assign(size, 0);
+            for (auto& completed : store->m_completed)
+            {
+                completed.assign(size, 0);
+            }
+            std::map<uint32_t, std::unique_ptr<StoredAchievement<Metadata, SharedData, DataAccess>>> achievements;
+            for (uint32_t index = 0; index < size; ++index)
+            {
+                store->Recount(index);
+                auto [_, inserted] = achievements.try_emplace(
+                    store->m_ids[index], std::make_unique<StoredAchievement<Metadata, SharedData, DataAccess>>(store, index));
+                if (!inserted)
+                {
+                    throw std::runtime_error(std::format("Achievement {} added twice", store->m_ids[index]));
+                }
+            }
+            return achievements;
+        }
+    };
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "game_enhancer/data_accessor.h"
+
+namespace GE
+{
+    enum class FieldType : uint8_t
+    {
+        Bool,
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+    };
+
+    template <typename T>
+    constexpr FieldType FieldTypeOf()
+    {
+        using U = std::remove_cv_t<T>;
+        if constexpr (std::is_same_v<U, bool>)
+        {
+            return FieldType::Bool;
+        }
+        else if constexpr (std::is_same_v<U, int8_t>)
+        {
+            return FieldType::Int8;
+        }
+        else if constexpr (std::is_same_v<U, uint8_t>)
+        {
+            return FieldType::UInt8;
+        }
+        else if constexpr (std::is_same_v<U, int16_t>)
+        {
+            return FieldType::Int16;
+        }
+        else if constexpr (std::is_same_v<U, uint16_t>)
+        {
+            return FieldType::UInt16;
+        }
+        else if constexpr (std::is_same_v<U, int32_t>)
+        {
+            return FieldType::Int32;
+        }
+        else if constexpr (std::is_same_v<U, uint32_t>)
+        {
+            return FieldType::UInt32;
+        }
+        else if constexpr (std::is_same_v<U, int64_t>)
+        {
+            return FieldType::Int64;
+        }
+        else if constexpr (std::is_same_v<U, uint64_t>)
+        {
+            return FieldType::UInt64;
+        }
+        else if constexpr (std::is_same_v<U, float>)
+        {
+            return FieldType::Float;
+        }
+        else if constexpr (std::is_same_v<U, double>)
+        {
+            return FieldType::Double;
+        }
+        else
+        {
+            static_assert(!sizeof(T), "Unsupported field type");
+        }
+    }
+
+    /*
+     * Node of a condition expression. Nodes are immutable and shared between expressions built from them.
+     */
+    struct ExpressionNode
+    {
+        enum class Op : uint8_t
+        {
+            Field,
+            Constant,
+            Delta,
+            Not,
+            And,
+            Or,
+            Add,
+            Sub,
+            Eq,
+            Ne,
+            Lt,
+            Le,
+        };
+
+        Op m_op = Op::Constant;
+        // Field
+        std::string m_layout;
+        size_t m_offset = 0;
+        FieldType m_type = FieldType::Int32;
+        // Constant
+        double m_value = 0.0;
+        std::vector<std::shared_ptr<const ExpressionNode>> m_operands;
+    };
+
+    /*
+     * Declarative condition over layout fields, e.g.
+     *   Field<int32_t>("Player", 8) >= 100 && Delta(Field<int32_t>("Player", 12)) > 0
+     * Values are evaluated as double, booleans are 0 and 1, see ExpressionEvaluator.
+     */
+    class Expression
+    {
+        std::shared_ptr<const ExpressionNode> m_node;
+
+    public:
+        explicit Expression(std::shared_ptr<const ExpressionNode> aNode)
+            : m_node(std::move(aNode))
+        {
+        }
+
+        // Implicit to allow comparisons with plain numbers
+        Expression(double aValue);
+
+        const ExpressionNode& GetNode() const { return *m_node; }
+
+        const std::shared_ptr<const ExpressionNode>& GetNodePtr() const { return m_node; }
+    };
+
+    /*
+     * Field of type aType at aOffset of the object of layout aLayout in the most recent frame.
+     */
+    Expression Field(std::string aLayout, size_t aOffset, FieldType aType);
+
+    template <typename T>
+    Expression Field(std::string aLayout, size_t aOffset)
+    {
+        return Field(std::move(aLayout), aOffset, FieldTypeOf<T>());
+    }
+
+    /*
+     * Change of aField against the previous frame, 0 when there is no previous frame.
+     */
+    Expression Delta(const Expression& aField);
+
+    /*
+     * aLow <= aValue && aValue <= aHigh
+     */
+    Expression InRange(const Expression& aValue, const Expression& aLow, const Expression& aHigh);
+
+    Expression operator!(const Expression& aOperand);
+    Expression operator&&(const Expression& aLeft, const Expression& aRight);
+    Expression operator||(const Expression& aLeft, const Expression& aRight);
+    Expression operator+(const Expression& aLeft, const Expression& aRight);
+    Expression operator-(const Expression& aLeft, const Expression& aRight);
+    Expression operator==(const Expression& aLeft, const Expression& aRight);
+    Expression operator!=(const Expression& aLeft, const Expression& aRight);
+    Expression operator<(const Expression& aLeft, const Expression& aRight);
+    Expression operator<=(const Expression& aLeft, const Expression& aRight);
+    Expression operator>(const Expression& aLeft, const Expression& aRight);
+    Expression operator>=(const Expression& aLeft, const Expression& aRight);
+
+    struct ExpressionEvaluator;
+    using ExpressionEvaluatorPtr = std::unique_ptr<ExpressionEvaluator>;
+
+    /*
+     * Evaluates condition expressions of all achievements at once. Expressions are compiled to instructions over registers
+     * when added, equal subexpressions share one register and every field is loaded once per frame, however many
+     * expressions read it. Usually owned by the SharedData of the achievements, their update callbacks read the results.
+     * Fields of missing objects are NaN, comparisons with NaN are false and NaN is false as a boolean.
+     */
+    struct ExpressionEvaluator
+    {
+        virtual ~ExpressionEvaluator() = default;
+
+        [[nodiscard]] static ExpressionEvaluatorPtr Create();
+
+        /*
+         * Returns the slot of the result of aExpression.
+         */
+        virtual size_t Add(const Expression& aExpression) = 0;
+
+        /*
+         * Evaluates all expressions on the most recent frame of aDataAccess. Repeated calls for the same frame do nothing
+         * unless expressions were added in between.
+         */
+        virtual void Evaluate(const DataAccessor& aDataAccess) = 0;
+
+        virtual double GetValue(size_t aSlot) const = 0;
+
+        virtual bool IsTrue(size_t aSlot) const = 0;
+
+        virtual size_t GetInstructionCount() const = 0;
+
+        virtual size_t GetFieldLoadCount() const = 0;
+    };
+}
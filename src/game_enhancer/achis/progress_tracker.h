@@ -1,12 +1,16 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <ranges>
-#include <unordered_set>
+#include <span>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include "game_enhancer/achis/conditions.h"
+#include "game_enhancer/clock.h"
 #include "game_enhancer/data_accessor.h"
 #include "pma/impl/callback/callback.h"
 #include "spdlog/spdlog.h"
@@ -14,22 +18,47 @@
 namespace GE
 {
     struct ProgressTracker;
+    class ConditionTrackers;
 
     class BaseProgressData
     {
-        std::unordered_set<ProgressTracker*> m_modifiedTrackers;
+        std::vector<ProgressTracker*> m_modifiedTrackers;
+        // A tracker changed since the last TakeChanged
+        bool m_changed = false;
 
     public:
-        virtual ~BaseProgressData() = default;
+        BaseProgressData() = default;
 
-        void AddModifiedTracker(ProgressTracker* aTracker) { m_modifiedTrackers.insert(aTracker); }
+        // Modified trackers are trackers of this object, copies start without any
+        BaseProgressData(const BaseProgressData&) {}
 
-        std::unordered_set<ProgressTracker*> ExtractModifiedTrackers()
+        BaseProgressData& operator=(const BaseProgressData&)
         {
-            decltype(m_modifiedTrackers) result;
-            std::swap(m_modifiedTrackers, result);
-            return result;
+            ClearModifiedTrackers();
+            m_changed = true;
+            return *this;
         }
+
+        virtual ~BaseProgressData() = default;
+
+        /*
+         * Moves trackers modified since the last call to aOut, replacing its content. The buffers are swapped and
+         * keep their capacity, passing the same aOut every time makes steady updates allocation free.
+         */
+        void ExtractModifiedTrackers(std::vector<ProgressTracker*>& aOut);
+
+        /*
+         * True when a tracker changed since the last call, regardless of ExtractModifiedTrackers.
+         */
+        bool TakeChanged() { return std::exchange(m_changed, false); }
+
+    private:
+        // Changes are reported by ProgressTracker::MarkModified, which also keeps the completion counters up to date
+        friend struct ProgressTracker;
+
+        void AddModifiedTracker(ProgressTracker* aTracker);
+
+        void ClearModifiedTrackers();
     };
 
     struct ProgressTracker
@@ -42,6 +71,17 @@ namespace GE
 
         uint32_t GetId() const { return m_id; }
 
+        // A copy would report its changes to the owner of the original, trackers are created in place by their owner
+        ProgressTracker(const ProgressTracker&) = delete;
+
+        // Owner and condition membership belong to the place of the tracker in its ProgressData, assignment takes the rest
+        ProgressTracker& operator=(const ProgressTracker& aOther)
+        {
+            m_staticMessage = aOther.m_staticMessage;
+            m_id = aOther.m_id;
+            return *this;
+        }
+
     protected:
         static uint32_t GetUniqueId()
         {
@@ -59,11 +99,165 @@ namespace GE
             }
         }
 
+        /*
+         * Has to be called after every change of the tracker, aWasCompleted is IsCompleted() before the change.
+         */
+        void MarkModified(bool aWasCompleted);
+
         BaseProgressData* m_owner;
         std::string m_staticMessage;
         uint32_t m_id = GetUniqueId();
+
+    private:
+        friend class BaseProgressData;
+        friend class ConditionTrackers;
+
+        // Listed in the modified trackers of m_owner
+        bool m_modified = false;
+        ConditionTrackers* m_conditions = nullptr;
+        // Bit per ConditionType the tracker is assigned to
+        uint8_t m_conditionMask = 0;
     };
 
+    /*
+     * Trackers of an achievement per ConditionType. Keeps the number of completed trackers of each type up to date as
+     * trackers change, so checking whether all or any trackers of a type are completed does not visit them.
+     */
+    class ConditionTrackers
+    {
+        static constexpr size_t kTypes = static_cast<size_t>(ConditionType::All);
+        static_assert(kTypes <= 8, "ProgressTracker::m_conditionMask has a bit per ConditionType");
+
+        std::array<std::vector<ProgressTracker*>, kTypes> m_trackers;
+        std::array<size_t, kTypes> m_completed{};
+
+    public:
+        ConditionTrackers() = default;
+        ConditionTrackers(const ConditionTrackers&) = delete;
+        ConditionTrackers& operator=(const ConditionTrackers&) = delete;
+
+        ~ConditionTrackers() { Clear(); }
+
+        /*
+         * A tracker can be assigned to several types, but only to types of a single ConditionTrackers.
+         */
+        void Add(ConditionType aConditionType, ProgressTracker* aTracker)
+        {
+            auto type = static_cast<size_t>(aConditionType);
+            if (type >= kTypes)
+            {
+                throw std::invalid_argument(std::format("Invalid condition type {}", type));
+            }
+            if (aTracker->m_conditions && aTracker->m_conditions != this)
+            {
+                throw std::runtime_error(
+                    std::format("Tracker {} belongs to conditions of another achievement", aTracker->GetId()));
+            }
+            uint8_t bit = uint8_t{1} << type;
+            if (aTracker->m_conditionMask & bit)
+            {
+                return;
+            }
+            aTracker->m_conditions = this;
+            aTracker->m_conditionMask |= bit;
+            m_trackers[type].push_back(aTracker);
+            m_completed[type] += aTracker->IsCompleted() ? 1 : 0;
+        }
+
+        std::span<ProgressTracker* const> Get(ConditionType aConditionType) const
+        {
+            return m_trackers.at(static_cast<size_t>(aConditionType));
+        }
+
+        /*
+         * True for a type without trackers.
+         */
+        bool AllCompleted(ConditionType aConditionType) const
+        {
+            auto type = static_cast<size_t>(aConditionType);
+            return m_completed[type] == m_trackers[type].size();
+        }
+
+        bool AnyCompleted(ConditionType aConditionType) const { return m_completed[static_cast<size_t>(aConditionType)] > 0; }
+
+        /*
+         * Counts completed trackers again, needed when trackers were changed without MarkModified, e.g. by deserialization.
+         */
+        void Recount()
+        {
+            for (size_t type = 0; type < kTypes; ++type)
+            {
+                m_completed[type] = std::ranges::count_if(m_trackers[type], &ProgressTracker::IsCompleted);
+            }
+        }
+
+        void Clear()
+        {
+            for (auto& trackers : m_trackers)
+            {
+                for (auto* tracker : trackers)
+                {
+                    tracker->m_conditions = nullptr;
+                    tracker->m_conditionMask = 0;
+                }
+                trackers.clear();
+            }
+            m_completed = {};
+        }
+
+    private:
+        friend struct ProgressTracker;
+
+        void OnCompletionChanged(uint8_t aMask, bool aCompleted)
+        {
+            for (size_t type = 0; type < kTypes; ++type)
+            {
+                if (aMask & (uint8_t{1} << type))
+                {
+                    aCompleted ? ++m_completed[type] : --m_completed[type];
+                }
+            }
+        }
+    };
+
+    inline void BaseProgressData::AddModifiedTracker(ProgressTracker* aTracker)
+    {
+        m_changed = true;
+        if (!aTracker->m_modified)
+        {
+            aTracker->m_modified = true;
+            m_modifiedTrackers.push_back(aTracker);
+        }
+    }
+
+    inline void BaseProgressData::ExtractModifiedTrackers(std::vector<ProgressTracker*>& aOut)
+    {
+        aOut.clear();
+        std::swap(m_modifiedTrackers, aOut);
+        for (auto* tracker : aOut)
+        {
+            tracker->m_modified = false;
+        }
+    }
+
+    inline void BaseProgressData::ClearModifiedTrackers()
+    {
+        for (auto* tracker : m_modifiedTrackers)
+        {
+            tracker->m_modified = false;
+        }
+        m_modifiedTrackers.clear();
+    }
+
+    inline void ProgressTracker::MarkModified(bool aWasCompleted)
+    {
+        m_owner->AddModifiedTracker(this);
+        if (m_conditions && IsCompleted() != aWasCompleted)
+        {
+            m_conditions->OnCompletionChanged(m_conditionMask, !aWasCompleted);
+        }
+    }
+
     template <typename T>
     std::string UnboundDynamicMessage(T aCurrent, T aTarget)
     {
@@ -109,8 +303,9 @@ namespace GE
             {
                 return;
             }
+            bool wasCompleted = IsCompleted();
             m_target = aTarget;
-            m_owner->AddModifiedTracker(this);
+            MarkModified(wasCompleted);
         }
 
         T GetCurrent() const { return m_current; }
@@ -121,8 +316,9 @@ namespace GE
             {
                 return;
             }
+            bool wasCompleted = IsCompleted();
             m_current = aCurrent;
-            m_owner->AddModifiedTracker(this);
+            MarkModified(wasCompleted);
         }
     };
 
@@ -215,25 +411,49 @@ namespace GE
     {
         bool m_running = false;
         bool m_paused = false;
-        std::chrono::steady_clock::time_point m_startTime;
-        std::chrono::steady_clock::time_point m_pauseStarted;
-        std::chrono::steady_clock::duration m_pauseDuration = std::chrono::steady_clock::duration::zero();
+        ClockPtr m_clock;
+        Clock::TimePoint m_startTime;
+        Clock::TimePoint m_pauseStarted;
+        Clock::TimePoint::duration m_pauseDuration = Clock::TimePoint::duration::zero();
+
+        int GetElapsedSeconds() const
+        {
+            auto elapsed = (m_clock->Now() - m_pauseDuration) - m_startTime;
+            return static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count());
+        }
 
     public:
-        ProgressTrackerTimer(BaseProgressData* aOwner, int aTarget, const std::string& aStaticMessage = "Time remaining")
+        /*
+         * aClock should be the clock of the MemoryProcessor, see MemoryProcessor::GetClock.
+         */
+        ProgressTrackerTimer(BaseProgressData* aOwner, int aTarget, const std::string& aStaticMessage = "Time remaining",
+                             ClockPtr aClock = Clock::GetSteady())
             : ProgressTrackerT(aOwner, aStaticMessage, aTarget, 0, &MinSecDynamicMessage<int>)
+            , m_clock(std::move(aClock))
         {
         }
 
         using AssignOps<int, ProgressTrackerTimer>::operator=;
 
+        /*
+         * Timer has to be stopped, time points of different clocks cannot be compared.
+         */
+        void SetClock(ClockPtr aClock)
+        {
+            if (m_running)
+            {
+                throw std::runtime_error("Cannot change clock of a running timer");
+            }
+            m_clock = std::move(aClock);
+        }
+
         void Start()
         {
             if (m_running)
             {
                 return;
             }
-            m_startTime = std::chrono::steady_clock::now();
+            m_startTime = m_clock->Now();
             m_running = true;
             m_paused = false;
         }
@@ -252,7 +472,7 @@ namespace GE
         {
             m_running = false;
             m_paused = false;
-            m_pauseDuration = std::chrono::steady_clock::duration::zero();
+            m_pauseDuration = Clock::TimePoint::duration::zero();
             SetCurrent(0);
         }
 
@@ -265,11 +485,11 @@ namespace GE
             m_paused = aPause;
             if (m_paused)
             {
-                m_pauseStarted = std::chrono::steady_clock::now();
+                m_pauseStarted = m_clock->Now();
             }
             else
             {
-                m_pauseDuration += std::chrono::steady_clock::now() - m_pauseStarted;
+                m_pauseDuration += m_clock->Now() - m_pauseStarted;
             }
         }
 
@@ -279,14 +499,18 @@ namespace GE
             {
                 return;
             }
-            auto elapsed = (std::chrono::steady_clock::now() - m_pauseDuration) - m_startTime;
-            SetCurrent(static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count()));
+            SetCurrent(GetElapsedSeconds());
             if (IsCompleted())
             {
                 Stop();
             }
         }
 
+        /*
+         * True when Update would advance the timer, i.e. another second elapsed since the last Update.
+         */
+        bool IsUpdateDue() const { return m_running && !m_paused && GetElapsedSeconds() != GetCurrent(); }
+
         bool IsRunning() const { return m_running; }
 
         bool IsPaused() const { return m_paused; }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "spdlog/spdlog.h"
+
+namespace GE
+{
+    struct SaveWriter;
+    using SaveWriterPtr = std::unique_ptr<SaveWriter>;
+
+    /*
+     * Thread writing save files in the background, see AchievementManager::SaveAsync.
+     * Every file is written to a temporary file next to it and renamed over it, so a crash never leaves a partial save.
+     * A write requested while an earlier write of the same file still waits replaces the earlier data, both requests
+     * complete once the newer data is written.
+     */
+    struct SaveWriter
+    {
+        virtual ~SaveWriter() = default;
+
+        /*
+         * Pending writes are finished on destruction.
+         */
+        [[nodiscard]] static SaveWriterPtr Create(std::shared_ptr<spdlog::logger> aLogger);
+
+        /*
+         * The future is ready once aData is in aPath and rethrows the error of a failed write.
+         */
+        virtual std::shared_future<void> Write(std::filesystem::path aPath, std::string aData) = 0;
+
+        /*
+         * Waits for all writes requested so far.
+         */
+        virtual void Wait() = 0;
+    };
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "game_enhancer/achis/progress_tracker.h"
+#include "game_enhancer/data_accessor.h"
+
+namespace GE
+{
+    /*
+     * Bits: 1 less than the target, 2 equal, 4 greater. NaN never completes a tracker.
+     */
+    enum class CompareKind : uint8_t
+    {
+        Less = 1,
+        Equal = 2,
+        LessEqual = 3,
+        Greater = 4,
+        NotEqual = 5,
+        GreaterEqual = 6,
+    };
+
+    template <typename T>
+    class ProgressTrackerColumn;
+
+    /*
+     * Values, targets and compare kinds of many numeric trackers in contiguous columns, usually shared by all achievements.
+     * Evaluate computes completion of all trackers at once with SIMD compare kernels. Values can be written in bulk through
+     * GetValues, changes take effect in the next Evaluate; SetValue and ProgressTrackerColumn take effect right away.
+     * Adding and removing trackers is not thread safe, trackers of different achievements can be modified concurrently.
+     * Has to outlive its ProgressTrackerColumn views.
+     */
+    template <typename T>
+    class TrackerColumns
+    {
+        static_assert(std::is_same_v<T, int32_t> || std::is_same_v<T, float>, "Columns hold int32_t or float trackers");
+
+        std::vector<T> m_values;
+        // Values as of the last Evaluate, bulk changes are found by comparing against them
+        std::vector<T> m_previousValues;
+        std::vector<T> m_targets;
+        // CompareKind, 0 for free slots
+        std::vector<uint8_t> m_kinds;
+        std::vector<uint8_t> m_completed;
+        std::vector<uint8_t> m_previousCompleted;
+        std::vector<ProgressTrackerColumn<T>*> m_views;
+        std::vector<uint32_t> m_free;
+        std::vector<ChangedRange> m_changes;
+
+        void Update(uint32_t aIndex);
+
+    public:
+        TrackerColumns() = default;
+        TrackerColumns(const TrackerColumns&) = delete;
+        TrackerColumns& operator=(const TrackerColumns&) = delete;
+
+        /*
+         * Returns the index of the new tracker, indices of removed trackers are reused.
+         */
+        uint32_t Add(T aTarget, T aValue, CompareKind aKind, ProgressTrackerColumn<T>* aView = nullptr);
+
+        void Remove(uint32_t aIndex);
+
+        size_t GetSize() const { return m_values.size(); }
+
+        T GetValue(uint32_t aIndex) const { return m_values[aIndex]; }
+
+        void SetValue(uint32_t aIndex, T aValue);
+
+        T GetTarget(uint32_t aIndex) const { return m_targets[aIndex]; }
+
+        void SetTarget(uint32_t aIndex, T aTarget);
+
+        CompareKind GetKind(uint32_t aIndex) const { return static_cast<CompareKind>(m_kinds[aIndex]); }
+
+        bool IsCompleted(uint32_t aIndex) const { return m_completed[aIndex]; }
+
+        /*
+         * Completion of all trackers as of the last change, 1 for completed trackers.
+         */
+        std::span<const uint8_t> GetCompleted() const { return m_completed; }
+
+        /*
+         * For bulk writes, see Evaluate.
+         */
+        std::span<T> GetValues() { return m_values; }
+
+        /*
+         * Recomputes completion of all trackers. Views of trackers whose values were changed through GetValues are reported
+         * as modified to their progress data.
+         */
+        void Evaluate();
+    };
+
+    /*
+     * Numeric progress tracker whose value, target and completion live in TrackerColumns.
+     */
+    template <typename T>
+    class ProgressTrackerColumn : public ProgressTracker,
+                                  public ArithmeticOps<T, ProgressTrackerColumn<T>>,
+                                  public AssignOps<T, ProgressTrackerColumn<T>>
+    {
+        friend class TrackerColumns<T>;
+
+        TrackerColumns<T>* m_columns;
+        uint32_t m_index;
+
+        void OnColumnChanged(bool aWasCompleted) { MarkModified(aWasCompleted); }
+
+    public:
+        ProgressTrackerColumn(BaseProgressData* aOwner, const std::string& aStaticMessage, TrackerColumns<T>& aColumns,
+                              T aTarget, T aCurrent = {}, CompareKind aKind = CompareKind::GreaterEqual)
+            : ProgressTracker(aOwner, aStaticMessage)
+            , m_columns(&aColumns)
+            , m_index(aColumns.Add(aTarget, aCurrent, aKind, this))
+        {
+        }
+
+        ProgressTrackerColumn(const ProgressTrackerColumn& aOther)
+            : ProgressTracker(aOther)
+            , m_columns(aOther.m_columns)
+            , m_index(m_columns->Add(aOther.GetTarget(), aOther.GetCurrent(), aOther.GetKind(), this))
+        {
+        }
+
+        // Copies the values, the tracker keeps its own slot
+        ProgressTrackerColumn& operator=(const ProgressTrackerColumn& aOther)
+        {
+            ProgressTracker::operator=(aOther);
+            m_columns->SetTarget(m_index, aOther.GetTarget());
+            m_columns->SetValue(m_index, aOther.GetCurrent());
+            return *this;
+        }
+
+        using AssignOps<T, ProgressTrackerColumn<T>>::operator=;
+
+        ~ProgressTrackerColumn() override { m_columns->Remove(m_index); }
+
+        bool IsCompleted() const override { return m_columns->IsCompleted(m_index); }
+
+        std::string GetMessage() const override
+        {
+            return std::format("{}: {} / {}", m_staticMessage, GetCurrent(), GetTarget());
+        }
+
+        uint32_t GetIndex() const { return m_index; }
+
+        CompareKind GetKind() const { return m_columns->GetKind(m_index); }
+
+        T GetCurrent() const { return m_columns->GetValue(m_index); }
+
+        void SetCurrent(T aCurrent)
+        {
+            if (aCurrent == GetCurrent())
+            {
+                return;
+            }
+            bool wasCompleted = IsCompleted();
+            m_columns->SetValue(m_index, aCurrent);
+            MarkModified(wasCompleted);
+        }
+
+        T GetTarget() const { return m_columns->GetTarget(m_index); }
+
+        void SetTarget(T aTarget)
+        {
+            if (aTarget == GetTarget())
+            {
+                return;
+            }
+            bool wasCompleted = IsCompleted();
+            m_columns->SetTarget(m_index, aTarget);
+            MarkModified(wasCompleted);
+        }
+    };
+
+    using ProgressTrackerIntColumn = ProgressTrackerColumn<int32_t>;
+    using ProgressTrackerFloatColumn = ProgressTrackerColumn<float>;
+}
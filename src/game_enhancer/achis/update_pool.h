@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace GE
+{
+    struct UpdatePool;
+    using UpdatePoolPtr = std::unique_ptr<UpdatePool>;
+
+    /*
+     * Worker threads running achievement updates, see AchievementManager::SetParallelUpdate.
+     */
+    struct UpdatePool
+    {
+        virtual ~UpdatePool() = default;
+
+        /*
+         * Work-stealing pool of aWorkers threads. The thread waiting in Run helps with the tasks.
+         */
+        [[nodiscard]] static UpdatePoolPtr Create(size_t aWorkers);
+
+        /*
+         * Calls aTask for every index in [0, aTasks) and returns once all of them finished.
+         * Rethrows the first exception thrown by any of the tasks.
+         */
+        virtual void Run(size_t aTasks, const std::function<void(size_t)>& aTask) = 0;
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+
+#include "pma/memory_core.h"
+
+namespace GE
+{
+    struct BatchReader;
+    using BatchReaderPtr = std::shared_ptr<BatchReader>;
+
+    /*
+     * Reads memory of the target process in batches. Queued reads are allowed to complete in any order and are only guaranteed
+     * to be finished after Flush() returns.
+     */
+    struct BatchReader
+    {
+        virtual ~BatchReader() = default;
+
+        /*
+         * Linux only. Reads '/proc/<aPid>/mem' through io_uring, keeping up to 'aQueueDepth' reads in flight.
+         * Falls back to plain pread when io_uring is not available or does not support reads (IORING_OP_READ, Linux 5.6).
+         */
+        [[nodiscard]] static BatchReaderPtr CreateProcMemReader(int aPid, size_t aQueueDepth = 256);
+
+        /*
+         * aBytesRead receives the number of bytes actually read once the read completes (0 on failure).
+         */
+        virtual void Queue(PMA::MemoryAddress aAddress, void* aBuffer, size_t aBytes, size_t* aBytesRead) = 0;
+
+        /*
+         * Submits all queued reads and waits until every one of them completes.
+         */
+        virtual void Flush() = 0;
+    };
+}
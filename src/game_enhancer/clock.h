@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+namespace GE
+{
+    struct Clock;
+    using ClockPtr = std::shared_ptr<Clock>;
+
+    struct VirtualClock;
+    using VirtualClockPtr = std::shared_ptr<VirtualClock>;
+
+    /*
+     * Time source of the MemoryProcessor and of everything driven by it, e.g. frame timestamps, update consumers, frame
+     * budget and ProgressTrackerTimer. Share one clock between all of them, time points of different clocks do not mix.
+     */
+    struct Clock
+    {
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        virtual ~Clock() = default;
+
+        /*
+         * Real time backed by std::chrono::steady_clock. Used by default.
+         */
+        [[nodiscard]] static ClockPtr GetSteady();
+
+        virtual TimePoint Now() const = 0;
+
+        /*
+         * Waits until aTime. Returns immediately when aTime already passed.
+         */
+        virtual void SleepUntil(TimePoint aTime) = 0;
+    };
+
+    /*
+     * Clock which moves only when told to. SleepUntil advances the time instead of blocking, so the main loop runs back to back
+     * and a captured or simulated session is processed as fast as frames can be read, with the same timestamps every run.
+     * Time does not pass while a frame is read, therefore the frame budget never runs out.
+     */
+    struct VirtualClock : Clock
+    {
+        [[nodiscard]] static VirtualClockPtr Create(TimePoint aStart = {});
+
+        virtual void Advance(std::chrono::nanoseconds aDuration) = 0;
+    };
+}
@@ -1,9 +1,35 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <span>
 #include <string>
 
 namespace GE
 {
+    struct ChangedRange
+    {
+        size_t m_offset = 0;
+        size_t m_size = 0;
+    };
+
+    /*
+     * Nodes collected by a walk, see Layout::Builder::AddListWalk. aWalk is the value of the walked pointer field of a stored
+     * object, the field is declared with the type of the first node but points to the collected nodes.
+     */
+    template <typename T>
+    std::span<const T* const> GetWalkedNodes(const void* aWalk)
+    {
+        if (!aWalk)
+        {
+            return {};
+        }
+        // Number of nodes followed by pointers to them
+        const auto* header = static_cast<const size_t*>(aWalk);
+        return {reinterpret_cast<const T* const*>(header + 1), header[0]};
+    }
+
     struct DataAccessor
     {
         virtual ~DataAccessor() = default;
@@ -11,6 +37,46 @@ namespace GE
         virtual const uint8_t* GetRaw(const std::string& aLayout, size_t aFrameIdx = 0) const = 0;
 
         virtual size_t GetNumberOfFrames() const = 0;
+
+        /*
+         * Number of frame aFrameIdx since the start of the main loop. Consecutive sequences mean no frame was read in between.
+         */
+        virtual size_t GetSequence(size_t aFrameIdx = 0) const = 0;
+
+        /*
+         * Returns index of the stored frame read closest to 'aAgo' before the most recent frame.
+         * Useful with MemoryProcessor::SetHistoryTiers, where older frames are not evenly spaced.
+         */
+        virtual size_t FindFrame(std::chrono::milliseconds aAgo) const = 0;
+
+        /*
+         * Byte ranges of aObject which changed against the frame read before frame aFrameIdx.
+         * aObject has to be a stored object of that frame, i.e. a layout base or a resolved pointer.
+         * Pointers are stored translated, a pointer field changes also when its pointee changed.
+         * Empty when nothing changed, objects without a counterpart in the previous frame are changed entirely.
+         */
+        virtual std::span<const ChangedRange> GetChangedRanges(const void* aObject, size_t aFrameIdx = 0) const = 0;
+
+        /*
+         * True when aObject was not read in frame aFrameIdx because the frame budget ran out, and the data of the frame
+         * before was reused instead.
+         */
+        virtual bool IsStale(const void* aObject, size_t aFrameIdx = 0) const = 0;
+
+        bool HasChanged(const void* aObject, size_t aOffset, size_t aSize, size_t aFrameIdx = 0) const
+        {
+            return std::ranges::any_of(GetChangedRanges(aObject, aFrameIdx), [&](const ChangedRange& aRange) {
+                return aRange.m_offset < aOffset + aSize && aOffset < aRange.m_offset + aRange.m_size;
+            });
+        }
+
+        template <typename T, typename F>
+        bool HasChanged(const T* aObject, F T::*aField, size_t aFrameIdx = 0) const
+        {
+            auto offset = reinterpret_cast<const uint8_t*>(&(aObject->*aField)) - reinterpret_cast<const uint8_t*>(aObject);
+            return HasChanged(aObject, static_cast<size_t>(offset), sizeof(F), aFrameIdx);
+        }
+
         /*
          * aFrameIdx 0 is the most recent frame, 1 is the frame before that, etc.
         */
@@ -19,5 +85,11 @@ namespace GE
         {
             return reinterpret_cast<const T*>(GetRaw(aLayout, aFrameIdx));
         }
+
+        template <typename T>
+        auto GetAgo(const std::string& aLayout, std::chrono::milliseconds aAgo) const
+        {
+            return Get<T>(aLayout, FindFrame(aAgo));
+        }
     };
 }
@@ -0,0 +1,385 @@
+#pragma once
+
+#include "game_enhancer/impl/achis/achievement_journal.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include "game_enhancer/log.h"
+#include "game_enhancer/utils/serialization.h"
+
+#ifdef __linux__
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace GE
+{
+    namespace
+    {
+        using States = AchievementJournal::States;
+
+        constexpr uint32_t kMagic = 0x314A4547; // "GEJ1"
+
+        enum class RecordKind : uint8_t
+        {
+            Checkpoint = 1,
+            Delta = 2,
+        };
+
+        // Kind, id, payload size and CRC-32 of everything else in the record. Checkpoints store the number of states as id.
+        constexpr size_t kHeaderSize = sizeof(RecordKind) + 3 * sizeof(uint32_t);
+        constexpr size_t kCheckedHeaderSize = kHeaderSize - sizeof(uint32_t);
+
+        constexpr auto kCrcTable = []() {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < table.size(); ++i)
+            {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                }
+                table[i] = crc;
+            }
+            return table;
+        }();
+
+        uint32_t Crc32(std::string_view aData, uint32_t aCrc = 0)
+        {
+            aCrc = ~aCrc;
+            for (auto c : aData)
+            {
+                aCrc = kCrcTable[(aCrc ^ static_cast<uint8_t>(c)) & 0xFF] ^ (aCrc >> 8);
+            }
+            return ~aCrc;
+        }
+
+        template <typename T>
+        void Put(std::string& aOut, const T& aValue)
+        {
+            aOut.append(reinterpret_cast<const char*>(&aValue), sizeof(T));
+        }
+
+        template <typename T>
+        T Get(const char* aIn)
+        {
+            T value;
+            std::memcpy(&value, aIn, sizeof(T));
+            return value;
+        }
+
+        void AppendRecord(std::string& aOut, RecordKind aKind, uint32_t aId, std::string_view aPayload)
+        {
+            auto start = aOut.size();
+            Put(aOut, aKind);
+            Put(aOut, aId);
+            Put(aOut, static_cast<uint32_t>(aPayload.size()));
+            Put(aOut, Crc32(aPayload, Crc32(std::string_view(aOut).substr(start))));
+            aOut.append(aPayload);
+        }
+
+        std::string EncodeCheckpoint(const States& aStates)
+        {
+            std::string payload;
+            for (const auto& [id, state] : aStates)
+            {
+                Put(payload, id);
+                Put(payload, static_cast<uint32_t>(state.size()));
+                payload.append(state);
+            }
+            std::string out;
+            Put(out, kMagic);
+            AppendRecord(out, RecordKind::Checkpoint, static_cast<uint32_t>(aStates.size()), payload);
+            return out;
+        }
+
+        bool DecodeCheckpoint(std::string_view aPayload, uint32_t aCount, States& aStates)
+        {
+            States states;
+            for (uint32_t i = 0; i < aCount; ++i)
+            {
+                if (aPayload.size() < 2 * sizeof(uint32_t))
+                {
+                    return false;
+                }
+                auto id = Get<uint32_t>(aPayload.data());
+                auto size = Get<uint32_t>(aPayload.data() + sizeof(uint32_t));
+                aPayload.remove_prefix(2 * sizeof(uint32_t));
+                if (aPayload.size() < size)
+                {
+                    return false;
+                }
+                states[id] = aPayload.substr(0, size);
+                aPayload.remove_prefix(size);
+            }
+            aStates = std::move(states);
+            return true;
+        }
+
+        /*
+         * Applies the intact records in the first aLimit bytes of aIn to aStates, in order.
+         */
+        void ReadRecords(std::istream& aIn, uint64_t aLimit, States& aStates, const std::filesystem::path& aPath)
+        {
+            BinReader br(aIn);
+            auto magic = br.Read<uint32_t>();
+            if (!aIn)
+            {
+                return;
+            }
+            if (magic != kMagic)
+            {
+                throw std::runtime_error(std::format("{} is not an achievement journal", aPath.string()));
+            }
+            uint64_t offset = sizeof(kMagic);
+            std::array<char, kHeaderSize> header;
+            std::string payload;
+            while (offset + kHeaderSize <= aLimit)
+            {
+                br.Read(header.data(), header.size());
+                if (!aIn)
+                {
+                    return;
+                }
+                auto kind = static_cast<RecordKind>(header[0]);
+                auto id = Get<uint32_t>(header.data() + sizeof(RecordKind));
+                auto size = Get<uint32_t>(header.data() + sizeof(RecordKind) + sizeof(uint32_t));
+                auto crc = Get<uint32_t>(header.data() + kCheckedHeaderSize);
+                if (offset + kHeaderSize + size > aLimit)
+                {
+                    return;
+                }
+                payload.resize(size);
+                br.Read(payload.data(), size);
+                if (!aIn || Crc32(payload, Crc32({header.data(), kCheckedHeaderSize})) != crc)
+                {
+                    return;
+                }
+                if (kind == RecordKind::Delta)
+                {
+                    aStates[id] = payload;
+                }
+                else if (kind != RecordKind::Checkpoint || !DecodeCheckpoint(payload, id, aStates))
+                {
+                    return;
+                }
+                offset += kHeaderSize + size;
+            }
+        }
+
+        /*
+         * Flushes the file or directory at aPath to the disk.
+         */
+        void SyncFile(const std::filesystem::path& aPath)
+        {
+#ifdef __linux__
+            int fd = open(aPath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0 || fsync(fd) != 0)
+            {
+                auto error = errno;
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+                throw std::runtime_error(std::format("Failed to sync {}: {}", aPath.string(), std::strerror(error)));
+            }
+            close(fd);
+#endif
+        }
+
+        void WriteFile(const std::filesystem::path& aPath, std::string_view aData)
+        {
+            std::ofstream out(aPath, std::ios::binary | std::ios::trunc);
+            out.write(aData.data(), aData.size());
+            out.close();
+            if (!out)
+            {
+                throw std::runtime_error(std::format("Failed to write {}", aPath.string()));
+            }
+        }
+    }
+
+    AchievementJournalImpl::AchievementJournalImpl(std::filesystem::path aPath, size_t aCompactAfter,
+                                                   std::shared_ptr<spdlog::logger> aLogger)
+        : m_path(std::move(aPath))
+        , m_compactAfter(aCompactAfter)
+        , m_compactAt(aCompactAfter)
+        , m_logger(std::move(aLogger))
+    {
+    }
+
+    AchievementJournalImpl::~AchievementJournalImpl()
+    {
+        try
+        {
+            if (m_out.is_open())
+            {
+                Flush();
+            }
+            WaitForCompaction();
+        }
+        catch (const std::exception& e)
+        {
+            m_logger->error("Failed to close achievement journal {}: {}", m_path.string(), e.what());
+        }
+    }
+
+    std::filesystem::path AchievementJournalImpl::GetTempPath() const
+    {
+        auto path = m_path;
+        path += ".tmp";
+        return path;
+    }
+
+    void AchievementJournalImpl::Replace(uint64_t aCheckpointSize, uint64_t aTailSize)
+    {
+        m_out.close();
+        // The rename must not reach the disk before the content it refers to
+        SyncFile(GetTempPath());
+        std::filesystem::rename(GetTempPath(), m_path);
+        SyncFile(m_path.has_parent_path() ? m_path.parent_path() : std::filesystem::path("."));
+        m_out.open(m_path, std::ios::binary | std::ios::app);
+        if (!m_out)
+        {
+            throw std::runtime_error(std::format("Failed to open achievement journal {}", m_path.string()));
+        }
+        m_fileSize = aCheckpointSize + aTailSize;
+        m_tailSize = aTailSize;
+        m_compactAt = m_compactAfter;
+    }
+
+    void AchievementJournalImpl::StartCompaction()
+    {
+        GE_LOG_TRACE(m_logger, "Compacting achievement journal {}", m_path.string());
+        m_compactedSize = m_fileSize;
+        m_compaction = std::async(std::launch::async, [path = m_path, temp = GetTempPath(), size = m_compactedSize]() {
+            States states;
+            {
+                std::ifstream in(path, std::ios::binary);
+                ReadRecords(in, size, states, path);
+            }
+            WriteFile(temp, EncodeCheckpoint(states));
+        });
+    }
+
+    void AchievementJournalImpl::FinishCompaction()
+    {
+        try
+        {
+            m_compaction.get();
+        }
+        catch (const std::exception& e)
+        {
+            m_logger->error("Failed to compact achievement journal {}: {}", m_path.string(), e.what());
+            std::error_code error;
+            std::filesystem::remove(GetTempPath(), error);
+            BackOffCompaction();
+            return;
+        }
+
+        // Deltas appended during the compaction are moved over to the compacted journal
+        auto checkpointSize = std::filesystem::file_size(GetTempPath());
+        auto tailSize = m_fileSize - m_compactedSize;
+        if (tailSize)
+        {
+            std::ifstream in(m_path, std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(m_compactedSize));
+            std::ofstream out(GetTempPath(), std::ios::binary | std::ios::app);
+            out << in.rdbuf();
+            out.close();
+            if (!out)
+            {
+                BackOffCompaction();
+                throw std::runtime_error(std::format("Failed to write {}", GetTempPath().string()));
+            }
+        }
+        auto previousSize = m_fileSize;
+        Replace(checkpointSize, tailSize);
+        m_logger->info("Achievement journal compacted from {} to {} bytes", previousSize, m_fileSize);
+    }
+
+    void AchievementJournalImpl::BackOffCompaction()
+    {
+        m_compactAt = m_tailSize + m_compactAfter;
+    }
+
+    void AchievementJournalImpl::WriteCheckpoint(const States& aStates)
+    {
+        if (m_compaction.valid())
+        {
+            // Superseded by the checkpoint
+            m_compaction.wait();
+            m_compaction = {};
+        }
+        m_pending.clear();
+        auto checkpoint = EncodeCheckpoint(aStates);
+        WriteFile(GetTempPath(), checkpoint);
+        Replace(checkpoint.size(), 0);
+    }
+
+    void AchievementJournalImpl::Append(uint32_t aId, std::string_view aState)
+    {
+        if (!m_out.is_open())
+        {
+            throw std::runtime_error("Achievement journal needs a checkpoint before the first delta");
+        }
+        AppendRecord(m_pending, RecordKind::Delta, aId, aState);
+    }
+
+    void AchievementJournalImpl::Flush()
+    {
+        if (m_compaction.valid() && m_compaction.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            FinishCompaction();
+        }
+        if (!m_pending.empty())
+        {
+            m_out.write(m_pending.data(), m_pending.size());
+            m_out.flush();
+            if (!m_out)
+            {
+                throw std::runtime_error(std::format("Failed to append to achievement journal {}", m_path.string()));
+            }
+            m_fileSize += m_pending.size();
+            m_tailSize += m_pending.size();
+            m_pending.clear();
+        }
+        if (!m_compaction.valid() && m_tailSize >= m_compactAt)
+        {
+            StartCompaction();
+        }
+    }
+
+    void AchievementJournalImpl::WaitForCompaction()
+    {
+        if (m_compaction.valid())
+        {
+            m_compaction.wait();
+            FinishCompaction();
+        }
+    }
+
+    AchievementJournalPtr AchievementJournal::Create(std::filesystem::path aPath, size_t aCompactAfter,
+                                                     std::shared_ptr<spdlog::logger> aLogger)
+    {
+        return std::make_unique<AchievementJournalImpl>(std::move(aPath), aCompactAfter, std::move(aLogger));
+    }
+
+    States AchievementJournal::Read(const std::filesystem::path& aPath)
+    {
+        States states;
+        std::ifstream in(aPath, std::ios::binary);
+        if (!in)
+        {
+            return states;
+        }
+        ReadRecords(in, std::filesystem::file_size(aPath), states, aPath);
+        return states;
+    }
+}
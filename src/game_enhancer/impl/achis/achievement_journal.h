@@ -0,0 +1,62 @@
+#pragma once
+
+#include <fstream>
+#include <future>
+
+#include "game_enhancer/achis/achievement_journal.h"
+
+namespace GE
+{
+    class AchievementJournalImpl : public AchievementJournal
+    {
+        std::filesystem::path m_path;
+        size_t m_compactAfter;
+        // Tail size starting the next compaction, raised after a failed one
+        uint64_t m_compactAt;
+        std::shared_ptr<spdlog::logger> m_logger;
+
+        std::ofstream m_out;
+        // Delta records waiting for Flush
+        std::string m_pending;
+        uint64_t m_fileSize = 0;
+        uint64_t m_tailSize = 0;
+
+        // Compaction of the first m_compactedSize bytes into the temporary file
+        std::future<void> m_compaction;
+        uint64_t m_compactedSize = 0;
+
+        std::filesystem::path GetTempPath() const;
+
+        /*
+         * Replaces the journal with the temporary file, a checkpoint of aCheckpointSize bytes followed by aTailSize bytes of
+         * deltas.
+         */
+        void Replace(uint64_t aCheckpointSize, uint64_t aTailSize);
+
+        void StartCompaction();
+
+        void FinishCompaction();
+
+        /*
+         * Postpones the next compaction until another m_compactAfter bytes of deltas were written.
+         */
+        void BackOffCompaction();
+
+    public:
+        AchievementJournalImpl(std::filesystem::path aPath, size_t aCompactAfter, std::shared_ptr<spdlog::logger> aLogger);
+
+        ~AchievementJournalImpl() override;
+
+        void WriteCheckpoint(const States& aStates) override;
+
+        void Append(uint32_t aId, std::string_view aState) override;
+
+        void Flush() override;
+
+        void WaitForCompaction() override;
+
+        bool IsCompacting() const override { return m_compaction.valid(); }
+
+        uint64_t GetTailSize() const override { return m_tailSize; }
+    };
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#include "game_enhancer/impl/achis/condition_expression.h"
+
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+namespace GE
+{
+    namespace
+    {
+        using Op = ExpressionNode::Op;
+
+        Expression MakeNode(Op aOp, std::vector<std::shared_ptr<const ExpressionNode>> aOperands)
+        {
+            auto node = std::make_shared<ExpressionNode>();
+            node->m_op = aOp;
+            node->m_operands = std::move(aOperands);
+            return Expression(std::move(node));
+        }
+
+        Expression MakeBinary(Op aOp, const Expression& aLeft, const Expression& aRight)
+        {
+            return MakeNode(aOp, {aLeft.GetNodePtr(), aRight.GetNodePtr()});
+        }
+
+        template <typename T>
+        double Load(const uint8_t* aField)
+        {
+            T value;
+            std::memcpy(&value, aField, sizeof(T));
+            return static_cast<double>(value);
+        }
+
+        double Load(const uint8_t* aField, FieldType aType)
+        {
+            switch (aType)
+            {
+            case FieldType::Bool:
+                return Load<bool>(aField);
+            case FieldType::Int8:
+                return Load<int8_t>(aField);
+            case FieldType::UInt8:
+                return Load<uint8_t>(aField);
+            case FieldType::Int16:
+                return Load<int16_t>(aField);
+            case FieldType::UInt16:
+                return Load<uint16_t>(aField);
+            case FieldType::Int32:
+                return Load<int32_t>(aField);
+            case FieldType::UInt32:
+                return Load<uint32_t>(aField);
+            case FieldType::Int64:
+                return Load<int64_t>(aField);
+            case FieldType::UInt64:
+                return Load<uint64_t>(aField);
+            case FieldType::Float:
+                return Load<float>(aField);
+            case FieldType::Double:
+                return Load<double>(aField);
+            }
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        bool IsTruthy(double aValue)
+        {
+            return aValue != 0.0 && !std::isnan(aValue);
+        }
+
+        bool IsCommutative(Op aOp)
+        {
+            return aOp == Op::And || aOp == Op::Or || aOp == Op::Add || aOp == Op::Eq || aOp == Op::Ne;
+        }
+    }
+
+    Expression::Expression(double aValue)
+    {
+        auto node = std::make_shared<ExpressionNode>();
+        node->m_op = ExpressionNode::Op::Constant;
+        node->m_value = aValue;
+        m_node = std::move(node);
+    }
+
+    Expression Field(std::string aLayout, size_t aOffset, FieldType aType)
+    {
+        auto node = std::make_shared<ExpressionNode>();
+        node->m_op = Op::Field;
+        node->m_layout = std::move(aLayout);
+        node->m_offset = aOffset;
+        node->m_type = aType;
+        return Expression(std::move(node));
+    }
+
+    Expression Delta(const Expression& aField)
+    {
+        if (aField.GetNode().m_op != Op::Field)
+        {
+            throw std::invalid_argument("Delta can be taken only of a field");
+        }
+        return MakeNode(Op::Delta, {aField.GetNodePtr()});
+    }
+
+    Expression InRange(const Expression& aValue, const Expression& aLow, const Expression& aHigh)
+    {
+        return aLow <= aValue && aValue <= aHigh;
+    }
+
+    Expression operator!(const Expression& aOperand)
+    {
+        return MakeNode(Op::Not, {aOperand.GetNodePtr()});
+    }
+
+    Expression operator&&(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::And, aLeft, aRight);
+    }
+
+    Expression operator||(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Or, aLeft, aRight);
+    }
+
+    Expression operator+(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Add, aLeft, aRight);
+    }
+
+    Expression operator-(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Sub, aLeft, aRight);
+    }
+
+    Expression operator==(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Eq, aLeft, aRight);
+    }
+
+    Expression operator!=(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Ne, aLeft, aRight);
+    }
+
+    Expression operator<(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Lt, aLeft, aRight);
+    }
+
+    Expression operator<=(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Le, aLeft, aRight);
+    }
+
+    // Greater comparisons are compiled as swapped less comparisons, x > y and y < x share a register
+    Expression operator>(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Lt, aRight, aLeft);
+    }
+
+    Expression operator>=(const Expression& aLeft, const Expression& aRight)
+    {
+        return MakeBinary(Op::Le, aRight, aLeft);
+    }
+
+    uint32_t ExpressionEvaluatorImpl::NewRegister(double aValue)
+    {
+        m_registers.push_back(aValue);
+        return static_cast<uint32_t>(m_registers.size() - 1);
+    }
+
+    uint32_t ExpressionEvaluatorImpl::CompileLoad(const ExpressionNode& aNode, size_t aFrameIdx)
+    {
+        auto [base, newBase] = m_baseIndex.try_emplace({aNode.m_layout, aFrameIdx}, static_cast<uint32_t>(m_bases.size()));
+        if (newBase)
+        {
+            m_bases.emplace_back(aNode.m_layout, aFrameIdx);
+        }
+        auto [load, newLoad] = m_loadIndex.try_emplace({base->second, aNode.m_offset, aNode.m_type}, 0);
+        if (newLoad)
+        {
+            load->second = NewRegister(std::numeric_limits<double>::quiet_NaN());
+            m_loads.push_back({base->second, aNode.m_offset, aNode.m_type, load->second});
+        }
+        return load->second;
+    }
+
+    uint32_t ExpressionEvaluatorImpl::CompileInstruction(Op aOp, uint32_t aLeft, uint32_t aRight)
+    {
+        if (IsCommutative(aOp) && aRight < aLeft)
+        {
+            std::swap(aLeft, aRight);
+        }
+        auto [instruction, inserted] = m_instructionIndex.try_emplace({aOp, aLeft, aRight}, 0);
+        if (inserted)
+        {
+            instruction->second = NewRegister();
+            m_instructions.push_back({aOp, instruction->second, aLeft, aRight});
+        }
+        return instruction->second;
+    }
+
+    uint32_t ExpressionEvaluatorImpl::Compile(const ExpressionNode& aNode)
+    {
+        switch (aNode.m_op)
+        {
+        case Op::Field:
+            return CompileLoad(aNode, 0);
+        case Op::Constant:
+        {
+            auto [constant, inserted] = m_constantIndex.try_emplace(aNode.m_value, 0);
+            if (inserted)
+            {
+                constant->second = NewRegister(aNode.m_value);
+            }
+            return constant->second;
+        }
+        case Op::Delta:
+        {
+            const auto& field = *aNode.m_operands.at(0);
+            return CompileInstruction(Op::Delta, CompileLoad(field, 0), CompileLoad(field, 1));
+        }
+        case Op::Not:
+            return CompileInstruction(Op::Not, Compile(*aNode.m_operands.at(0)));
+        default:
+            if (aNode.m_operands.size() != 2)
+            {
+                throw std::invalid_argument(
+                    std::format("Expression operation {} needs two operands", static_cast<int>(aNode.m_op)));
+            }
+            return CompileInstruction(aNode.m_op, Compile(*aNode.m_operands[0]), Compile(*aNode.m_operands[1]));
+        }
+    }
+
+    size_t ExpressionEvaluatorImpl::Add(const Expression& aExpression)
+    {
+        m_results.push_back(Compile(aExpression.GetNode()));
+        m_added = true;
+        return m_results.size() - 1;
+    }
+
+    void ExpressionEvaluatorImpl::Evaluate(const DataAccessor& aDataAccess)
+    {
+        auto frames = aDataAccess.GetNumberOfFrames();
+        auto sequence = frames ? std::optional(aDataAccess.GetSequence()) : std::nullopt;
+        if (!m_added && sequence == m_lastSequence)
+        {
+            return;
+        }
+        m_added = false;
+        m_lastSequence = sequence;
+
+        // Every object is looked up once, every field is loaded once
+        m_baseObjects.resize(m_bases.size());
+        for (size_t i = 0; i < m_bases.size(); ++i)
+        {
+            const auto& [layout, frameIdx] = m_bases[i];
+            m_baseObjects[i] = frameIdx < frames ? aDataAccess.GetRaw(layout, frameIdx) : nullptr;
+        }
+        for (const auto& load : m_loads)
+        {
+            const auto* base = m_baseObjects[load.m_base];
+            m_registers[load.m_dst] =
+                base ? Load(base + load.m_offset, load.m_type) : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        // Operands are compiled before their users, one pass in order evaluates everything
+        auto* r = m_registers.data();
+        for (const auto& instruction : m_instructions)
+        {
+            auto left = r[instruction.m_left];
+            auto right = r[instruction.m_right];
+            double result = 0.0;
+            switch (instruction.m_op)
+            {
+            case Op::Delta:
+                result = std::isnan(right) ? 0.0 : left - right;
+                break;
+            case Op::Not:
+                result = !IsTruthy(left);
+                break;
+            case Op::And:
+                result = IsTruthy(left) && IsTruthy(right);
+                break;
+            case Op::Or:
+                result = IsTruthy(left) || IsTruthy(right);
+                break;
+            case Op::Add:
+                result = left + right;
+                break;
+            case Op::Sub:
+                result = left - right;
+                break;
+            case Op::Eq:
+                result = left == right;
+                break;
+            case Op::Ne:
+                // False with NaN like the other comparisons
+                result = left < right || left > right;
+                break;
+            case Op::Lt:
+                result = left < right;
+                break;
+            case Op::Le:
+                result = left <= right;
+                break;
+            default:
+                break;
+            }
+            r[instruction.m_dst] = result;
+        }
+    }
+
+    double ExpressionEvaluatorImpl::GetValue(size_t aSlot) const
+    {
+        return m_registers[m_results.at(aSlot)];
+    }
+
+    bool ExpressionEvaluatorImpl::IsTrue(size_t aSlot) const
+    {
+        return IsTruthy(GetValue(aSlot));
+    }
+
+    ExpressionEvaluatorPtr ExpressionEvaluator::Create()
+    {
+        return std::make_unique<ExpressionEvaluatorImpl>();
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "game_enhancer/achis/condition_expression.h"
+
+namespace GE
+{
+    class ExpressionEvaluatorImpl : public ExpressionEvaluator
+    {
+        using Op = ExpressionNode::Op;
+
+        /*
+         * m_dst = m_op(m_left, m_right), operands and results are register indices.
+         */
+        struct Instruction
+        {
+            Op m_op;
+            uint32_t m_dst;
+            uint32_t m_left;
+            uint32_t m_right;
+        };
+
+        struct FieldLoad
+        {
+            uint32_t m_base;
+            size_t m_offset;
+            FieldType m_type;
+            uint32_t m_dst;
+        };
+
+        // Objects read by the loads, layout and frame index
+        std::vector<std::pair<std::string, size_t>> m_bases;
+        std::vector<const uint8_t*> m_baseObjects;
+        std::vector<FieldLoad> m_loads;
+        std::vector<Instruction> m_instructions;
+        std::vector<double> m_registers;
+        std::vector<uint32_t> m_results;
+
+        std::map<std::pair<std::string, size_t>, uint32_t> m_baseIndex;
+        std::map<std::tuple<uint32_t, size_t, FieldType>, uint32_t> m_loadIndex;
+        std::map<double, uint32_t> m_constantIndex;
+        std::map<std::tuple<Op, uint32_t, uint32_t>, uint32_t> m_instructionIndex;
+
+        std::optional<size_t> m_lastSequence;
+        bool m_added = false;
+
+        uint32_t NewRegister(double aValue = 0.0);
+
+        uint32_t CompileLoad(const ExpressionNode& aNode, size_t aFrameIdx);
+
+        uint32_t CompileInstruction(Op aOp, uint32_t aLeft, uint32_t aRight = 0);
+
+        uint32_t Compile(const ExpressionNode& aNode);
+
+    public:
+        size_t Add(const Expression& aExpression) override;
+
+        void Evaluate(const DataAccessor& aDataAccess) override;
+
+        double GetValue(size_t aSlot) const override;
+
+        bool IsTrue(size_t aSlot) const override;
+
+        size_t GetInstructionCount() const override { return m_instructions.size(); }
+
+        size_t GetFieldLoadCount() const override { return m_loads.size(); }
+    };
+}
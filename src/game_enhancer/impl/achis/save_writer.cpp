@@ -0,0 +1,114 @@
+#pragma once
+
+#include "game_enhancer/impl/achis/save_writer.h"
+
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#include "game_enhancer/log.h"
+
+namespace GE
+{
+    namespace
+    {
+        void WriteAtomically(const std::filesystem::path& aPath, const std::string& aData)
+        {
+            auto tempPath = aPath;
+            tempPath += ".tmp";
+            {
+                std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+                out.write(aData.data(), aData.size());
+                out.close();
+                if (!out)
+                {
+                    throw std::runtime_error(std::format("Failed to write {}", tempPath.string()));
+                }
+            }
+            std::filesystem::rename(tempPath, aPath);
+        }
+    }
+
+    SaveWriterImpl::SaveWriterImpl(std::shared_ptr<spdlog::logger> aLogger)
+        : m_logger(std::move(aLogger))
+    {
+        m_thread = std::jthread([this](std::stop_token aStopToken) {
+            WriterLoop(aStopToken);
+        });
+    }
+
+    SaveWriterImpl::~SaveWriterImpl()
+    {
+        m_thread.request_stop();
+        m_thread.join();
+    }
+
+    void SaveWriterImpl::WriterLoop(std::stop_token aStopToken)
+    {
+        while (true)
+        {
+            std::unique_lock lock(m_mutex);
+            m_changed.wait(lock, aStopToken, [this]() {
+                return !m_pending.empty();
+            });
+            // Requested writes are finished before stopping
+            if (m_pending.empty())
+            {
+                return;
+            }
+            auto request = std::move(m_pending.front());
+            m_pending.pop_front();
+            m_writing = true;
+            lock.unlock();
+
+            try
+            {
+                WriteAtomically(request.m_path, request.m_data);
+                GE_LOG_TRACE(m_logger, "Saved {} bytes to {}", request.m_data.size(), request.m_path.string());
+                request.m_done.set_value();
+            }
+            catch (const std::exception& e)
+            {
+                m_logger->error("Failed to save {}: {}", request.m_path.string(), e.what());
+                request.m_done.set_exception(std::current_exception());
+            }
+
+            lock.lock();
+            m_writing = false;
+            m_changed.notify_all();
+        }
+    }
+
+    std::shared_future<void> SaveWriterImpl::Write(std::filesystem::path aPath, std::string aData)
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto& request : m_pending)
+        {
+            if (request.m_path == aPath)
+            {
+                GE_LOG_TRACE(m_logger, "Coalesced save of {}", aPath.string());
+                request.m_data = std::move(aData);
+                return request.m_future;
+            }
+        }
+        auto& request = m_pending.emplace_back();
+        request.m_path = std::move(aPath);
+        request.m_data = std::move(aData);
+        request.m_future = request.m_done.get_future().share();
+        m_changed.notify_all();
+        return request.m_future;
+    }
+
+    void SaveWriterImpl::Wait()
+    {
+        std::unique_lock lock(m_mutex);
+        m_changed.wait(lock, [this]() {
+            return m_pending.empty() && !m_writing;
+        });
+    }
+
+    SaveWriterPtr SaveWriter::Create(std::shared_ptr<spdlog::logger> aLogger)
+    {
+        return std::make_unique<SaveWriterImpl>(std::move(aLogger));
+    }
+}
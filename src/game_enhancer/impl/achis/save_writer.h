@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "game_enhancer/achis/save_writer.h"
+
+namespace GE
+{
+    class SaveWriterImpl : public SaveWriter
+    {
+        struct Request
+        {
+            std::filesystem::path m_path;
+            std::string m_data;
+            std::promise<void> m_done;
+            std::shared_future<void> m_future;
+        };
+
+        std::shared_ptr<spdlog::logger> m_logger;
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_changed;
+        // Not started yet, at most one per path
+        std::deque<Request> m_pending;
+        bool m_writing = false;
+
+        std::jthread m_thread;
+
+        void WriterLoop(std::stop_token aStopToken);
+
+    public:
+        SaveWriterImpl(std::shared_ptr<spdlog::logger> aLogger);
+
+        ~SaveWriterImpl() override;
+
+        std::shared_future<void> Write(std::filesystem::path aPath, std::string aData) override;
+
+        void Wait() override;
+    };
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "game_enhancer/achis/tracker_columns.h"
+
+#include <cstring>
+
+#include "game_enhancer/impl/utils/compare_kernels.h"
+#include "game_enhancer/impl/utils/frame_diff.h"
+
+namespace GE
+{
+    static_assert(static_cast<uint8_t>(CompareKind::Less) == kRelationLess);
+    static_assert(static_cast<uint8_t>(CompareKind::Equal) == kRelationEqual);
+    static_assert(static_cast<uint8_t>(CompareKind::Greater) == kRelationGreater);
+
+    template <typename T>
+    void TrackerColumns<T>::Update(uint32_t aIndex)
+    {
+        m_previousValues[aIndex] = m_values[aIndex];
+        CompareColumns(&m_values[aIndex], &m_targets[aIndex], &m_kinds[aIndex], 1, &m_completed[aIndex]);
+    }
+
+    template <typename T>
+    uint32_t TrackerColumns<T>::Add(T aTarget, T aValue, CompareKind aKind, ProgressTrackerColumn<T>* aView)
+    {
+        uint32_t index = 0;
+        if (m_free.empty())
+        {
+            index = static_cast<uint32_t>(m_values.size());
+            m_values.push_back(aValue);
+            m_previousValues.push_back(aValue);
+            m_targets.push_back(aTarget);
+            m_kinds.push_back(static_cast<uint8_t>(aKind));
+            m_completed.push_back(0);
+            m_previousCompleted.push_back(0);
+            m_views.push_back(aView);
+        }
+        else
+        {
+            index = m_free.back();
+            m_free.pop_back();
+            m_values[index] = aValue;
+            m_targets[index] = aTarget;
+            m_kinds[index] = static_cast<uint8_t>(aKind);
+            m_views[index] = aView;
+        }
+        Update(index);
+        return index;
+    }
+
+    template <typename T>
+    void TrackerColumns<T>::Remove(uint32_t aIndex)
+    {
+        m_kinds[aIndex] = 0;
+        m_views[aIndex] = nullptr;
+        m_completed[aIndex] = 0;
+        m_free.push_back(aIndex);
+    }
+
+    template <typename T>
+    void TrackerColumns<T>::SetValue(uint32_t aIndex, T aValue)
+    {
+        m_values[aIndex] = aValue;
+        Update(aIndex);
+    }
+
+    template <typename T>
+    void TrackerColumns<T>::SetTarget(uint32_t aIndex, T aTarget)
+    {
+        m_targets[aIndex] = aTarget;
+        Update(aIndex);
+    }
+
+    template <typename T>
+    void TrackerColumns<T>::Evaluate()
+    {
+        std::swap(m_completed, m_previousCompleted);
+        CompareColumns(m_values.data(), m_targets.data(), m_kinds.data(), m_values.size(), m_completed.data());
+
+        m_changes.clear();
+        const auto* previous = reinterpret_cast<const uint8_t*>(m_previousValues.data());
+        const auto* current = reinterpret_cast<const uint8_t*>(m_values.data());
+        if (!DiffBytes(previous, current, m_values.size() * sizeof(T), m_changes))
+        {
+            return;
+        }
+        for (const auto& change : m_changes)
+        {
+            auto first = change.m_offset / sizeof(T);
+            auto last = (change.m_offset + change.m_size - 1) / sizeof(T);
+            for (auto index = first; index <= last; ++index)
+            {
+                m_previousValues[index] = m_values[index];
+                if (auto* view = m_views[index])
+                {
+                    view->OnColumnChanged(m_previousCompleted[index]);
+                }
+            }
+        }
+    }
+
+    template class TrackerColumns<int32_t>;
+    template class TrackerColumns<float>;
+}
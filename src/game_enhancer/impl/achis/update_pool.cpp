@@ -0,0 +1,34 @@
+#pragma once
+
+#include "game_enhancer/impl/achis/update_pool.h"
+
+#include <stdexcept>
+
+namespace GE
+{
+    UpdatePoolImpl::UpdatePoolImpl(size_t aWorkers)
+        : m_pool(aWorkers)
+    {
+    }
+
+    void UpdatePoolImpl::Run(size_t aTasks, const std::function<void(size_t)>& aTask)
+    {
+        TaskGroup group(m_pool);
+        for (size_t i = 0; i < aTasks; ++i)
+        {
+            group.Run([&aTask, i]() {
+                aTask(i);
+            });
+        }
+        group.Wait();
+    }
+
+    UpdatePoolPtr UpdatePool::Create(size_t aWorkers)
+    {
+        if (aWorkers == 0)
+        {
+            throw std::invalid_argument("Update pool needs at least one worker");
+        }
+        return std::make_unique<UpdatePoolImpl>(aWorkers);
+    }
+}
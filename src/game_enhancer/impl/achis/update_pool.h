@@ -0,0 +1,17 @@
+#pragma once
+
+#include "game_enhancer/achis/update_pool.h"
+#include "game_enhancer/impl/utils/work_stealing_pool.h"
+
+namespace GE
+{
+    class UpdatePoolImpl : public UpdatePool
+    {
+        WorkStealingPool m_pool;
+
+    public:
+        UpdatePoolImpl(size_t aWorkers);
+
+        void Run(size_t aTasks, const std::function<void(size_t)>& aTask) override;
+    };
+}
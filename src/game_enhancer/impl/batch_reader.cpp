@@ -0,0 +1,263 @@
+#pragma once
+
+#include "game_enhancer/impl/batch_reader.h"
+
+#include <format>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace GE
+{
+#ifdef __linux__
+    namespace
+    {
+        int IoUringSetup(unsigned aEntries, io_uring_params* aParams)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_setup, aEntries, aParams));
+        }
+
+        int IoUringEnter(int aFd, unsigned aToSubmit, unsigned aMinComplete, unsigned aFlags)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, aFd, aToSubmit, aMinComplete, aFlags, nullptr, 0));
+        }
+
+        int IoUringRegister(int aFd, unsigned aOpcode, void* aArg, unsigned aArgs)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_register, aFd, aOpcode, aArg, aArgs));
+        }
+
+        template <typename T>
+        T* RingField(void* aRing, uint32_t aOffset)
+        {
+            return reinterpret_cast<T*>(static_cast<uint8_t*>(aRing) + aOffset);
+        }
+    }
+
+    bool ProcMemBatchReader::SetupRing(size_t aQueueDepth)
+    {
+        io_uring_params params{};
+        int fd = IoUringSetup(static_cast<unsigned>(aQueueDepth), &params);
+        if (fd < 0)
+        {
+            return false;
+        }
+        m_ring.m_fd = fd;
+        if (!SupportsRead())
+        {
+            TeardownRing();
+            return false;
+        }
+        m_ring.m_entries = params.sq_entries;
+        m_ring.m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_ring.m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap)
+        {
+            m_ring.m_sqRingSize = m_ring.m_cqRingSize = std::max(m_ring.m_sqRingSize, m_ring.m_cqRingSize);
+        }
+        m_ring.m_sqRing = mmap(nullptr, m_ring.m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                               IORING_OFF_SQ_RING);
+        if (m_ring.m_sqRing == MAP_FAILED)
+        {
+            m_ring.m_sqRing = nullptr;
+            TeardownRing();
+            return false;
+        }
+        if (singleMmap)
+        {
+            m_ring.m_cqRing = m_ring.m_sqRing;
+        }
+        else
+        {
+            m_ring.m_cqRing = mmap(nullptr, m_ring.m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                   IORING_OFF_CQ_RING);
+            if (m_ring.m_cqRing == MAP_FAILED)
+            {
+                m_ring.m_cqRing = nullptr;
+                TeardownRing();
+                return false;
+            }
+        }
+        m_ring.m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        m_ring.m_sqes = mmap(nullptr, m_ring.m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (m_ring.m_sqes == MAP_FAILED)
+        {
+            m_ring.m_sqes = nullptr;
+            TeardownRing();
+            return false;
+        }
+        m_ring.m_sqTail = RingField<unsigned>(m_ring.m_sqRing, params.sq_off.tail);
+        m_ring.m_sqArray = RingField<unsigned>(m_ring.m_sqRing, params.sq_off.array);
+        m_ring.m_sqMask = *RingField<unsigned>(m_ring.m_sqRing, params.sq_off.ring_mask);
+        m_ring.m_cqHead = RingField<unsigned>(m_ring.m_cqRing, params.cq_off.head);
+        m_ring.m_cqTail = RingField<unsigned>(m_ring.m_cqRing, params.cq_off.tail);
+        m_ring.m_cqes = RingField<io_uring_cqe>(m_ring.m_cqRing, params.cq_off.cqes);
+        m_ring.m_cqMask = *RingField<unsigned>(m_ring.m_cqRing, params.cq_off.ring_mask);
+        return true;
+    }
+
+    bool ProcMemBatchReader::SupportsRead() const
+    {
+        // Kernels without the probe predate IORING_OP_READ as well
+        constexpr unsigned kOps = 256;
+        std::vector<uint8_t> buffer(sizeof(io_uring_probe) + kOps * sizeof(io_uring_probe_op));
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (IoUringRegister(m_ring.m_fd, IORING_REGISTER_PROBE, probe, kOps) < 0)
+        {
+            return false;
+        }
+        return probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    void ProcMemBatchReader::TeardownRing()
+    {
+        if (m_ring.m_sqes)
+        {
+            munmap(m_ring.m_sqes, m_ring.m_sqesSize);
+        }
+        if (m_ring.m_cqRing && m_ring.m_cqRing != m_ring.m_sqRing)
+        {
+            munmap(m_ring.m_cqRing, m_ring.m_cqRingSize);
+        }
+        if (m_ring.m_sqRing)
+        {
+            munmap(m_ring.m_sqRing, m_ring.m_sqRingSize);
+        }
+        if (m_ring.m_fd >= 0)
+        {
+            close(m_ring.m_fd);
+        }
+        m_ring = {};
+    }
+
+    void ProcMemBatchReader::FlushSync()
+    {
+        for (const auto& request : m_queued)
+        {
+            auto result = pread(m_memFd, request.m_buffer, request.m_bytes, static_cast<off_t>(request.m_address));
+            *request.m_bytesRead = result < 0 ? 0 : static_cast<size_t>(result);
+        }
+    }
+
+    void ProcMemBatchReader::FlushRing()
+    {
+        std::atomic_ref<unsigned> sqTail(*m_ring.m_sqTail);
+        std::atomic_ref<unsigned> cqHead(*m_ring.m_cqHead);
+        std::atomic_ref<unsigned> cqTail(*m_ring.m_cqTail);
+        auto* cqes = static_cast<io_uring_cqe*>(m_ring.m_cqes);
+        auto* sqes = static_cast<io_uring_sqe*>(m_ring.m_sqes);
+
+        size_t next = 0;
+        size_t inFlight = 0;
+        size_t completed = 0;
+        unsigned toSubmit = 0;
+        while (completed < m_queued.size())
+        {
+            // Keep the ring full, completions are reaped in bulk below
+            auto tail = sqTail.load(std::memory_order_relaxed);
+            while (next < m_queued.size() && inFlight < m_ring.m_entries)
+            {
+                const auto& request = m_queued[next];
+                auto index = tail & m_ring.m_sqMask;
+                auto& sqe = sqes[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_READ;
+                sqe.fd = m_memFd;
+                sqe.addr = reinterpret_cast<uint64_t>(request.m_buffer);
+                sqe.len = static_cast<uint32_t>(request.m_bytes);
+                sqe.off = request.m_address;
+                sqe.user_data = next;
+                m_ring.m_sqArray[index] = index;
+                ++tail;
+                ++next;
+                ++inFlight;
+                ++toSubmit;
+            }
+            sqTail.store(tail, std::memory_order_release);
+
+            int submitted = IoUringEnter(m_ring.m_fd, toSubmit, 1, IORING_ENTER_GETEVENTS);
+            if (submitted < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN)
+                {
+                    continue;
+                }
+                throw std::runtime_error(std::format("io_uring_enter failed: {}", std::strerror(errno)));
+            }
+            toSubmit -= static_cast<unsigned>(submitted);
+
+            auto head = cqHead.load(std::memory_order_relaxed);
+            auto available = cqTail.load(std::memory_order_acquire);
+            for (; head != available; ++head)
+            {
+                const auto& cqe = cqes[head & m_ring.m_cqMask];
+                *m_queued[cqe.user_data].m_bytesRead = cqe.res < 0 ? 0 : static_cast<size_t>(cqe.res);
+                --inFlight;
+                ++completed;
+            }
+            cqHead.store(head, std::memory_order_release);
+        }
+    }
+
+    ProcMemBatchReader::ProcMemBatchReader(int aPid, size_t aQueueDepth)
+    {
+        auto path = std::format("/proc/{}/mem", aPid);
+        m_memFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_memFd < 0)
+        {
+            throw std::runtime_error(std::format("Cannot open '{}': {}", path, std::strerror(errno)));
+        }
+        SetupRing(aQueueDepth);
+    }
+
+    ProcMemBatchReader::~ProcMemBatchReader()
+    {
+        TeardownRing();
+        close(m_memFd);
+    }
+
+    void ProcMemBatchReader::Queue(PMA::MemoryAddress aAddress, void* aBuffer, size_t aBytes, size_t* aBytesRead)
+    {
+        m_queued.push_back({aAddress, aBuffer, aBytes, aBytesRead});
+    }
+
+    void ProcMemBatchReader::Flush()
+    {
+        if (m_queued.empty())
+        {
+            return;
+        }
+        if (m_ring.m_fd >= 0)
+        {
+            FlushRing();
+        }
+        else
+        {
+            FlushSync();
+        }
+        m_queued.clear();
+    }
+
+    BatchReaderPtr BatchReader::CreateProcMemReader(int aPid, size_t aQueueDepth)
+    {
+        return std::make_shared<ProcMemBatchReader>(aPid, aQueueDepth);
+    }
+#else
+    BatchReaderPtr BatchReader::CreateProcMemReader(int, size_t)
+    {
+        throw std::runtime_error("ProcMemReader is only available on Linux");
+    }
+#endif
+}
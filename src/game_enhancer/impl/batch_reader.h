@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include "game_enhancer/batch_reader.h"
+
+namespace GE
+{
+    struct ReadRequest
+    {
+        PMA::MemoryAddress m_address = 0;
+        void* m_buffer = nullptr;
+        size_t m_bytes = 0;
+        size_t* m_bytesRead = nullptr;
+    };
+
+    class ProcMemBatchReader : public BatchReader
+    {
+        struct Ring
+        {
+            int m_fd = -1;
+            void* m_sqRing = nullptr;
+            size_t m_sqRingSize = 0;
+            void* m_cqRing = nullptr;
+            size_t m_cqRingSize = 0;
+            void* m_sqes = nullptr;
+            size_t m_sqesSize = 0;
+            unsigned m_entries = 0;
+
+            unsigned* m_sqTail = nullptr;
+            unsigned* m_sqArray = nullptr;
+            unsigned m_sqMask = 0;
+            unsigned* m_cqHead = nullptr;
+            unsigned* m_cqTail = nullptr;
+            void* m_cqes = nullptr;
+            unsigned m_cqMask = 0;
+        };
+
+        int m_memFd = -1;
+        Ring m_ring;
+        std::vector<ReadRequest> m_queued;
+
+        /*
+         * Returns false when the ring could not be set up or the kernel does not support IORING_OP_READ, reads are then
+         * done by pread.
+         */
+        bool SetupRing(size_t aQueueDepth);
+        bool SupportsRead() const;
+        void TeardownRing();
+        void FlushSync();
+        void FlushRing();
+
+    public:
+        ProcMemBatchReader(int aPid, size_t aQueueDepth);
+        ~ProcMemBatchReader();
+
+        void Queue(PMA::MemoryAddress aAddress, void* aBuffer, size_t aBytes, size_t* aBytesRead) override;
+        void Flush() override;
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "game_enhancer/impl/clock.h"
+
+#include <thread>
+
+namespace GE
+{
+    Clock::TimePoint SteadyClock::Now() const
+    {
+        return std::chrono::steady_clock::now();
+    }
+
+    void SteadyClock::SleepUntil(TimePoint aTime)
+    {
+        std::this_thread::sleep_until(aTime);
+    }
+
+    VirtualClockImpl::VirtualClockImpl(TimePoint aStart)
+        : m_now(aStart.time_since_epoch().count())
+    {
+    }
+
+    Clock::TimePoint VirtualClockImpl::Now() const
+    {
+        return TimePoint(TimePoint::duration(m_now.load(std::memory_order_acquire)));
+    }
+
+    void VirtualClockImpl::SleepUntil(TimePoint aTime)
+    {
+        // Never goes back, another thread might have advanced the clock further already
+        auto target = aTime.time_since_epoch().count();
+        auto current = m_now.load(std::memory_order_relaxed);
+        while (current < target && !m_now.compare_exchange_weak(current, target, std::memory_order_acq_rel))
+        {
+        }
+    }
+
+    void VirtualClockImpl::Advance(std::chrono::nanoseconds aDuration)
+    {
+        m_now.fetch_add(std::chrono::duration_cast<TimePoint::duration>(aDuration).count(), std::memory_order_acq_rel);
+    }
+
+    ClockPtr Clock::GetSteady()
+    {
+        static const auto steady = std::make_shared<SteadyClock>();
+        return steady;
+    }
+
+    VirtualClockPtr VirtualClock::Create(TimePoint aStart)
+    {
+        return std::make_shared<VirtualClockImpl>(aStart);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+
+#include "game_enhancer/clock.h"
+
+namespace GE
+{
+    class SteadyClock : public Clock
+    {
+    public:
+        TimePoint Now() const override;
+        void SleepUntil(TimePoint aTime) override;
+    };
+
+    class VirtualClockImpl : public VirtualClock
+    {
+        // Ticks of TimePoint::duration, read from consumer threads while the main loop advances it
+        std::atomic<TimePoint::rep> m_now;
+
+    public:
+        VirtualClockImpl(TimePoint aStart);
+
+        TimePoint Now() const override;
+        void SleepUntil(TimePoint aTime) override;
+        void Advance(std::chrono::nanoseconds aDuration) override;
+    };
+}
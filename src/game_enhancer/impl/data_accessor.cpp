@@ -3,11 +3,12 @@
 
 #include "data_accessor.h"
 
+#include <algorithm>
 #include <string>
 
 namespace GE
 {
-    std::shared_ptr<std::deque<FrameMemoryStorage>> DataAccessorImpl::EnsureValid() const
+    std::shared_ptr<const FrameHistory> DataAccessorImpl::EnsureValid() const
     {
         if (auto frameStorage = m_weakFrameStorage.lock())
         {
@@ -16,18 +17,66 @@ namespace GE
         throw std::logic_error("Memory access revoked!");
     }
 
-    DataAccessorImpl::DataAccessorImpl(std::weak_ptr<std::deque<FrameMemoryStorage>> aWeakFrameStorage)
+    const FrameMemoryStorage& DataAccessorImpl::GetFrame(const FrameHistory& aFrames, size_t aFrameIdx) const
+    {
+        if (aFrameIdx >= aFrames.size())
+        {
+            throw std::out_of_range("Frame index out of range");
+        }
+        return *aFrames[aFrames.size() - 1 - aFrameIdx];
+    }
+
+    DataAccessorImpl::DataAccessorImpl(std::weak_ptr<const FrameHistory> aWeakFrameStorage)
         : m_weakFrameStorage(std::move(aWeakFrameStorage))
     {
     }
 
     const uint8_t* DataAccessorImpl::GetRaw(const std::string& aLayout, size_t aFrameIdx) const
     {
-        return EnsureValid()->at(aFrameIdx).GetLayoutBase(aLayout);
+        return GetFrame(*EnsureValid(), aFrameIdx).FindLayoutBase(aLayout);
     }
 
     size_t DataAccessorImpl::GetNumberOfFrames() const
     {
         return EnsureValid()->size();
     }
+
+    size_t DataAccessorImpl::GetSequence(size_t aFrameIdx) const
+    {
+        return GetFrame(*EnsureValid(), aFrameIdx).GetSequence();
+    }
+
+    size_t DataAccessorImpl::FindFrame(std::chrono::milliseconds aAgo) const
+    {
+        auto frames = EnsureValid();
+        if (frames->empty())
+        {
+            throw std::out_of_range("No frames stored");
+        }
+        // Frames are ordered by timestamp, oldest first
+        auto target = frames->back()->GetTimestamp() - aAgo;
+        auto it = std::ranges::lower_bound(*frames, target, {}, [](const auto& aFrame) {
+            return aFrame->GetTimestamp();
+        });
+        if (it == frames->end())
+        {
+            return 0;
+        }
+        if (it != frames->begin() && target - (*std::prev(it))->GetTimestamp() < (*it)->GetTimestamp() - target)
+        {
+            --it;
+        }
+        return static_cast<size_t>(std::distance(it, frames->end()) - 1);
+    }
+
+    std::span<const ChangedRange> DataAccessorImpl::GetChangedRanges(const void* aObject, size_t aFrameIdx) const
+    {
+        // Ranges live in the frame, which stays alive as long as the accessor is used from the update callback
+        return GetFrame(*EnsureValid(), aFrameIdx).GetChangedRanges(static_cast<const uint8_t*>(aObject));
+    }
+
+    bool DataAccessorImpl::IsStale(const void* aObject, size_t aFrameIdx) const
+    {
+        return GetFrame(*EnsureValid(), aFrameIdx).IsStale(static_cast<const uint8_t*>(aObject));
+    }
 }
@@ -11,13 +11,18 @@ namespace GE
 {
     class DataAccessorImpl : public DataAccessor
     {
-        std::weak_ptr<std::deque<FrameMemoryStorage>> m_weakFrameStorage;
+        std::weak_ptr<const FrameHistory> m_weakFrameStorage;
 
-        std::shared_ptr<std::deque<FrameMemoryStorage>> EnsureValid() const;
+        std::shared_ptr<const FrameHistory> EnsureValid() const;
+        const FrameMemoryStorage& GetFrame(const FrameHistory& aFrames, size_t aFrameIdx) const;
 
     public:
-        DataAccessorImpl(std::weak_ptr<std::deque<FrameMemoryStorage>> aWeakFrameStorage);
+        DataAccessorImpl(std::weak_ptr<const FrameHistory> aWeakFrameStorage);
         const uint8_t* GetRaw(const std::string& aLayout, size_t aFrameIdx = 0) const override;
         size_t GetNumberOfFrames() const override;
+        size_t GetSequence(size_t aFrameIdx = 0) const override;
+        size_t FindFrame(std::chrono::milliseconds aAgo) const override;
+        std::span<const ChangedRange> GetChangedRanges(const void* aObject, size_t aFrameIdx = 0) const override;
+        bool IsStale(const void* aObject, size_t aFrameIdx = 0) const override;
     };
 }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "game_enhancer/impl/layout/append_tracker.h"
+
+namespace GE
+{
+    void AppendTracker::NextFrame()
+    {
+        std::scoped_lock lock(m_mutex);
+        if (++m_frame % kForgetAfter == 0)
+        {
+            std::erase_if(m_entries, [this](const auto& aEntry) {
+                return aEntry.second.m_lastSeen + kForgetAfter < m_frame;
+            });
+        }
+    }
+
+    bool AppendTracker::ShouldReadAppended(size_t aAddress)
+    {
+        std::scoped_lock lock(m_mutex);
+        auto& entry = m_entries[aAddress];
+        entry.m_lastSeen = m_frame;
+        if (entry.m_appendStreak < kTrustAfter || ++entry.m_sinceVerification >= kVerifyInterval)
+        {
+            entry.m_sinceVerification = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void AppendTracker::Observe(size_t aAddress, bool aAppended)
+    {
+        std::scoped_lock lock(m_mutex);
+        auto& entry = m_entries[aAddress];
+        entry.m_lastSeen = m_frame;
+        entry.m_appendStreak = aAppended ? entry.m_appendStreak + 1 : 0;
+    }
+
+    void AppendTracker::Clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        m_entries.clear();
+        m_frame = 0;
+    }
+}
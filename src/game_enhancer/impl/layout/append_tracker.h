@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace GE
+{
+    /*
+     * Learns which objects of dynamic size only grow by appending, e.g. chat or combat logs. Such objects are read
+     * from where the previous frame ended, plus a few guard bytes before it which must match the previous frame.
+     * Trusted objects are still read whole every kVerifyInterval frames, any mismatch makes them untrusted again.
+     * Objects are identified by their address, can be used from multiple threads.
+     */
+    class AppendTracker
+    {
+        struct Entry
+        {
+            size_t m_appendStreak = 0;
+            size_t m_sinceVerification = 0;
+            size_t m_lastSeen = 0;
+        };
+
+        std::mutex m_mutex;
+        std::unordered_map<size_t, Entry> m_entries;
+        size_t m_frame = 0;
+
+    public:
+        static constexpr size_t kTrustAfter = 3;
+        static constexpr size_t kVerifyInterval = 64;
+        static constexpr size_t kGuardBytes = 64;
+        // Objects not seen for this many frames are forgotten
+        static constexpr size_t kForgetAfter = 256;
+
+        void NextFrame();
+
+        /*
+         * True when only the appended bytes of the object at aAddress should be read in this frame.
+         */
+        bool ShouldReadAppended(size_t aAddress);
+
+        /*
+         * Records whether the whole object at aAddress was found to be the previous content with bytes appended.
+         */
+        void Observe(size_t aAddress, bool aAppended);
+
+        void Clear();
+    };
+}
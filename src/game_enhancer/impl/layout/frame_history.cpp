@@ -0,0 +1,89 @@
+#pragma once
+
+#include "game_enhancer/impl/layout/frame_history.h"
+
+#include <algorithm>
+
+namespace GE
+{
+    namespace
+    {
+        // Sequence numbers of stored frames are consecutive, unless a frame between them was evicted
+        bool FollowsStored(const FrameHistory& aFrames, size_t aIndex)
+        {
+            return aIndex > 0 && aIndex < aFrames.size() &&
+                   aFrames[aIndex - 1]->GetSequence() + 1 == aFrames[aIndex]->GetSequence();
+        }
+
+        size_t Retained(const FrameBytes& aBytes, bool aFollowsStored)
+        {
+            return aFollowsStored ? aBytes.m_freshBytes : aBytes.m_bytes;
+        }
+    }
+
+    void ApplyRetention(FrameHistory& aFrames, size_t aFramesToKeep, const std::vector<HistoryTier>& aTiers)
+    {
+        if (aTiers.empty())
+        {
+            while (aFrames.size() > aFramesToKeep)
+            {
+                aFrames.pop_front();
+            }
+            return;
+        }
+        if (aFrames.empty())
+        {
+            return;
+        }
+        const auto newestSequence = aFrames.back()->GetSequence();
+        const auto newestTimestamp = aFrames.back()->GetTimestamp();
+        // Frame kept by a coarser tier is also kept by the finer ones, so frames are promoted as they age
+        std::erase_if(aFrames, [&](const std::shared_ptr<FrameMemoryStorage>& aFrame) {
+            if (aFrame->GetSequence() + aFramesToKeep > newestSequence)
+            {
+                return false;
+            }
+            auto age = newestTimestamp - aFrame->GetTimestamp();
+            return std::ranges::none_of(aTiers, [&](const HistoryTier& aTier) {
+                return age <= aTier.m_span && aFrame->GetSequence() % aTier.m_stride == 0;
+            });
+        });
+    }
+
+    HistoryBytes CountRetainedBytes(const FrameHistory& aFrames)
+    {
+        HistoryBytes result;
+        for (size_t i = 0; i < aFrames.size(); ++i)
+        {
+            auto followsStored = FollowsStored(aFrames, i);
+            result.m_bytes += Retained(aFrames[i]->GetBytes(), followsStored);
+            for (const auto& [layout, bytes] : aFrames[i]->GetBytesByLayout())
+            {
+                result.m_bytesByLayout[layout] += Retained(bytes, followsStored);
+            }
+        }
+        return result;
+    }
+
+    size_t ApplyMemoryBudget(FrameHistory& aFrames, size_t aMinFrames, size_t aBudget)
+    {
+        size_t retained = 0;
+        for (size_t i = 0; i < aFrames.size(); ++i)
+        {
+            retained += Retained(aFrames[i]->GetBytes(), FollowsStored(aFrames, i));
+        }
+        size_t evicted = 0;
+        while (retained > aBudget && aFrames.size() > aMinFrames)
+        {
+            retained -= Retained(aFrames[0]->GetBytes(), false);
+            if (FollowsStored(aFrames, 1))
+            {
+                // The next frame loses its predecessor and becomes the owner of all of its blocks
+                retained += aFrames[1]->GetBytes().m_bytes - aFrames[1]->GetBytes().m_freshBytes;
+            }
+            aFrames.pop_front();
+            ++evicted;
+        }
+        return evicted;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "game_enhancer/impl/layout/frame_memory_storage.h"
+#include "game_enhancer/memory_processor.h"
+
+namespace GE
+{
+    /*
+     * Evicts frames which are neither one of the newest 'aFramesToKeep' frames nor selected by any of the tiers.
+     * Without tiers only the newest 'aFramesToKeep' frames are kept.
+     */
+    void ApplyRetention(FrameHistory& aFrames, size_t aFramesToKeep, const std::vector<HistoryTier>& aTiers);
+
+    struct HistoryBytes
+    {
+        size_t m_bytes = 0;
+        std::unordered_map<std::string, size_t> m_bytesByLayout;
+    };
+
+    /*
+     * A frame shares blocks only with the frame read right before it. When that frame is stored as well, only fresh bytes
+     * of the frame are counted, otherwise the whole frame is.
+     */
+    HistoryBytes CountRetainedBytes(const FrameHistory& aFrames);
+
+    /*
+     * Evicts the oldest frames until the retained bytes fit into aBudget, never going below aMinFrames frames.
+     * Returns number of evicted frames.
+     */
+    size_t ApplyMemoryBudget(FrameHistory& aFrames, size_t aMinFrames, size_t aBudget);
+}
@@ -2,6 +2,13 @@
 
 #include "game_enhancer/impl/layout/frame_memory_storage.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "game_enhancer/impl/utils/frame_diff.h"
+
 namespace GE
 {
     Metadata* GetMetadata(const uint8_t* fromData)
@@ -9,20 +16,235 @@ namespace GE
         return reinterpret_cast<Metadata*>(const_cast<uint8_t*>(fromData) - sizeof(Metadata));
     }
 
-    uint8_t* FrameMemoryStorage::Allocate(size_t aSize)
+    BlockPtr BlockPool::Acquire(size_t aSize, size_t aCapacity)
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            // Recently released blocks are at the back, objects of the same shape are usually freed and read together
+            auto fits = [aSize](const BlockPtr& aBlock) {
+                return aBlock->capacity() >= aSize && aBlock->capacity() <= 2 * aSize;
+            };
+            auto candidates = std::min<size_t>(m_free.size(), 16);
+            for (auto it = m_free.end() - candidates; it != m_free.end(); ++it)
+            {
+                if (fits(*it))
+                {
+                    auto block = std::move(*it);
+                    *it = std::move(m_free.back());
+                    m_free.pop_back();
+                    m_freeBytes -= block->capacity();
+                    // Failed reads leave the data untouched, stale content must not look like valid pointers
+                    block->assign(aSize, 0);
+                    return block;
+                }
+            }
+        }
+        auto block = std::make_shared<Block>();
+        block->reserve(std::max(aSize, aCapacity));
+        block->resize(aSize);
+        return block;
+    }
+
+    void BlockPool::Release(BlockPtr aBlock)
+    {
+        if (aBlock.use_count() != 1)
+        {
+            return;
+        }
+        std::scoped_lock lock(m_mutex);
+        if (m_free.size() < kMaxFreeBlocks && m_freeBytes + aBlock->capacity() <= kMaxFreeBytes)
+        {
+            m_freeBytes += aBlock->capacity();
+            m_free.push_back(std::move(aBlock));
+        }
+    }
+
+    const BlockPtr* FrameMemoryStorage::FindBlock(size_t aRealAddress) const
+    {
+        auto it = m_blockByAddress.find(aRealAddress);
+        if (it == m_blockByAddress.end())
+        {
+            return nullptr;
+        }
+        return &m_storage[it->second];
+    }
+
+    FrameMemoryStorage::FrameMemoryStorage(std::shared_ptr<BlockPool> aPool)
+        : m_pool(std::move(aPool))
+    {
+    }
+
+    FrameMemoryStorage::~FrameMemoryStorage()
+    {
+        if (m_pool)
+        {
+            // Blocks still shared with other frames are kept by the pool only once their last frame is gone
+            for (auto& block : m_storage)
+            {
+                m_pool->Release(std::move(block));
+            }
+        }
+    }
+
+    uint8_t* FrameMemoryStorage::Allocate(size_t aSize, size_t aRealAddress, size_t aCapacity)
     {
-        auto dataPtr = m_storage.emplace_back(std::vector<uint8_t>(sizeof(Metadata) + aSize)).data() + sizeof(Metadata);
+        auto& block = m_storage.emplace_back(m_pool ? m_pool->Acquire(sizeof(Metadata) + aSize,
+                                                                      aCapacity ? sizeof(Metadata) + aCapacity : 0)
+                                                    : std::make_shared<Block>(sizeof(Metadata) + aSize));
+        m_totalBytes.m_bytes += block->size();
+        m_totalBytes.m_freshBytes += block->size();
+        auto dataPtr = block->data() + sizeof(Metadata);
         *GetMetadata(dataPtr) = {};
+        GetMetadata(dataPtr)->m_realAddress = aRealAddress;
+        m_blockByAddress[aRealAddress] = m_storage.size() - 1;
         return dataPtr;
     }
 
+    const uint8_t* FrameMemoryStorage::FindData(size_t aRealAddress, size_t aSize) const
+    {
+        auto* block = FindBlock(aRealAddress);
+        if (!block || (*block)->size() != sizeof(Metadata) + aSize)
+        {
+            return nullptr;
+        }
+        return (*block)->data() + sizeof(Metadata);
+    }
+
+    std::span<const uint8_t> FrameMemoryStorage::FindObject(size_t aRealAddress) const
+    {
+        auto* block = FindBlock(aRealAddress);
+        if (!block)
+        {
+            return {};
+        }
+        return std::span<const uint8_t>(**block).subspan(sizeof(Metadata));
+    }
+
+    void FrameMemoryStorage::Adopt(const uint8_t* aData, const FrameMemoryStorage& aOwner)
+    {
+        auto realAddress = GetMetadata(aData)->m_realAddress;
+        auto ownsData = [aData](const BlockPtr& aBlock) {
+            return aBlock->data() + sizeof(Metadata) == aData;
+        };
+        auto* block = aOwner.FindBlock(realAddress);
+        if (!block || !ownsData(*block))
+        {
+            // Owner holds more objects of the same address, e.g. reused and freshly read one
+            auto it = std::ranges::find_if(aOwner.m_storage, ownsData);
+            if (it == aOwner.m_storage.end())
+            {
+                return;
+            }
+            block = &*it;
+        }
+        m_storage.push_back(*block);
+        m_totalBytes.m_bytes += (*block)->size();
+        m_blockByAddress.try_emplace(realAddress, m_storage.size() - 1);
+        m_staleData.insert(aData);
+    }
+
+    void FrameMemoryStorage::MarkChanged(uint8_t* aData, size_t aFirstRange)
+    {
+        auto* metadata = GetMetadata(aData);
+        metadata->m_dirty = true;
+        m_changesByAddress[metadata->m_realAddress] = {aFirstRange, m_changedRanges.size() - aFirstRange};
+    }
+
+    uint8_t* FrameMemoryStorage::ShareUnchanged(uint8_t* aData, const FrameMemoryStorage* aPrevious)
+    {
+        auto realAddress = GetMetadata(aData)->m_realAddress;
+        auto it = m_blockByAddress.find(realAddress);
+        if (it == m_blockByAddress.end())
+        {
+            return aData;
+        }
+        auto& current = m_storage[it->second];
+        auto dataSize = current->size() - sizeof(Metadata);
+        auto firstRange = m_changedRanges.size();
+        auto* previous = aPrevious ? aPrevious->FindBlock(realAddress) : nullptr;
+        if (!previous || current->data() + sizeof(Metadata) != aData || (*previous)->size() != current->size() ||
+            GetMetadata((*previous)->data() + sizeof(Metadata))->m_bytesRead != GetMetadata(aData)->m_bytesRead)
+        {
+            m_changedRanges.push_back({0, dataSize});
+            MarkChanged(aData, firstRange);
+            return aData;
+        }
+        auto* previousData = (*previous)->data() + sizeof(Metadata);
+        if (DiffBytes(previousData, aData, dataSize, m_changedRanges))
+        {
+            MarkChanged(aData, firstRange);
+            return aData;
+        }
+        auto fresh = std::exchange(current, *previous);
+        m_totalBytes.m_freshBytes -= fresh->size();
+        if (m_pool)
+        {
+            m_pool->Release(std::move(fresh));
+        }
+        return previousData;
+    }
+
+    std::span<const ChangedRange> FrameMemoryStorage::GetChangedRanges(const uint8_t* aData) const
+    {
+        auto it = m_changesByAddress.find(GetMetadata(aData)->m_realAddress);
+        if (it == m_changesByAddress.end())
+        {
+            return {};
+        }
+        return std::span(m_changedRanges).subspan(it->second.first, it->second.second);
+    }
+
+    bool FrameMemoryStorage::IsIdenticalTo(const FrameMemoryStorage& aPrevious) const
+    {
+        return m_changesByAddress.empty() && m_storage.size() == aPrevious.m_storage.size() &&
+               m_layoutBase == aPrevious.m_layoutBase;
+    }
+
+    void FrameMemoryStorage::Merge(FrameMemoryStorage&& aSlice)
+    {
+        auto offset = m_storage.size();
+        m_storage.reserve(offset + aSlice.m_storage.size());
+        std::move(aSlice.m_storage.begin(), aSlice.m_storage.end(), std::back_inserter(m_storage));
+        for (const auto& [address, index] : aSlice.m_blockByAddress)
+        {
+            m_blockByAddress.try_emplace(address, offset + index);
+        }
+        auto rangeOffset = m_changedRanges.size();
+        m_changedRanges.insert(m_changedRanges.end(), aSlice.m_changedRanges.begin(), aSlice.m_changedRanges.end());
+        for (const auto& [address, slice] : aSlice.m_changesByAddress)
+        {
+            m_changesByAddress.try_emplace(address, rangeOffset + slice.first, slice.second);
+        }
+        m_staleData.merge(aSlice.m_staleData);
+        m_totalBytes.m_bytes += aSlice.m_totalBytes.m_bytes;
+        m_totalBytes.m_freshBytes += aSlice.m_totalBytes.m_freshBytes;
+        aSlice.m_totalBytes = {};
+        aSlice.m_storage.clear();
+        aSlice.m_blockByAddress.clear();
+        aSlice.m_changedRanges.clear();
+        aSlice.m_changesByAddress.clear();
+        aSlice.m_staleData.clear();
+    }
+
     void FrameMemoryStorage::SetLayoutBase(const std::string& aLayoutType, uint8_t* aBase)
     {
         m_layoutBase[aLayoutType] = aBase;
     }
 
-    uint8_t* FrameMemoryStorage::GetLayoutBase(const std::string& aLayoutType)
+    void FrameMemoryStorage::SetLayoutBytes(const std::string& aLayoutType, const FrameBytes& aBytes)
+    {
+        m_bytesByLayout[aLayoutType] = aBytes;
+    }
+
+    const uint8_t* FrameMemoryStorage::FindLayoutBase(const std::string& aLayoutType) const
+    {
+        auto it = m_layoutBase.find(aLayoutType);
+        return it == m_layoutBase.end() ? nullptr : it->second;
+    }
+
+    void FrameMemoryStorage::SetFrameInfo(size_t aSequence, std::chrono::steady_clock::time_point aTimestamp)
     {
-        return m_layoutBase[aLayoutType];
+        m_sequence = aSequence;
+        m_timestamp = aTimestamp;
     }
 }
@@ -1,31 +1,173 @@
 #pragma once
 
+#include <chrono>
 #include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "game_enhancer/data_accessor.h"
+
 namespace GE
 {
     struct Metadata
     {
         size_t m_realAddress = 0;
         size_t m_bytesRead = 0;
+        /*
+         * Object differed from the previous frame when the block was read.
+         * Blocks shared into later frames keep the flag, use FrameMemoryStorage::GetChangedRanges for a specific frame.
+         */
         bool m_dirty = false;
     };
 
     Metadata* GetMetadata(const uint8_t* fromData);
 
+    using Block = std::vector<uint8_t>;
+    using BlockPtr = std::shared_ptr<Block>;
+
+    /*
+     * Keeps blocks which were allocated for a frame but turned out to be identical to the previous frame, and blocks of
+     * evicted frames. They are handed out again on later allocations, so objects do not cost a heap allocation every frame.
+     * Frames can be destroyed on any thread, the pool is synchronized.
+     */
+    class BlockPool
+    {
+        std::mutex m_mutex;
+        std::vector<BlockPtr> m_free;
+        size_t m_freeBytes = 0;
+
+    public:
+        static constexpr size_t kMaxFreeBlocks = 1024;
+        static constexpr size_t kMaxFreeBytes = 16 * 1024 * 1024;
+
+        /*
+         * Reuses a free block which fits aSize and is not more than twice as large as needed, so blocks of objects changing
+         * their size a little keep being reused while oversized blocks are not. New blocks reserve aCapacity bytes.
+         */
+        BlockPtr Acquire(size_t aSize, size_t aCapacity = 0);
+        void Release(BlockPtr aBlock);
+    };
+
+    /*
+     * Bytes of stored objects including their Metadata.
+     * m_bytes - All objects of the frame
+     * m_freshBytes - Objects not shared with the previous frame, i.e. memory the frame added on top of its predecessor
+     */
+    struct FrameBytes
+    {
+        size_t m_bytes = 0;
+        size_t m_freshBytes = 0;
+    };
+
+    /*
+     * Blocks are immutable once the frame is fully read. Consecutive frames share blocks of objects whose content
+     * did not change, so a block can be referenced by multiple frames at once.
+     */
     class FrameMemoryStorage
     {
-        std::deque<std::vector<uint8_t>> m_storage;
+        std::shared_ptr<BlockPool> m_pool;
+        std::vector<BlockPtr> m_storage;
+        std::unordered_map<size_t, size_t> m_blockByAddress;
         std::unordered_map<std::string, uint8_t*> m_layoutBase;
+        // Ranges of all changed objects, m_changesByAddress points to the slice belonging to an object
+        std::vector<ChangedRange> m_changedRanges;
+        std::unordered_map<size_t, std::pair<size_t, size_t>> m_changesByAddress;
+        // Objects reused from the previous frame without reading them
+        std::unordered_set<const uint8_t*> m_staleData;
+        size_t m_sequence = 0;
+        std::chrono::steady_clock::time_point m_timestamp;
+        FrameBytes m_totalBytes;
+        std::unordered_map<std::string, FrameBytes> m_bytesByLayout;
+
+        const BlockPtr* FindBlock(size_t aRealAddress) const;
+        void MarkChanged(uint8_t* aData, size_t aFirstRange);
 
     public:
-        uint8_t* Allocate(size_t aSize);
+        FrameMemoryStorage(std::shared_ptr<BlockPool> aPool = {});
+        FrameMemoryStorage(FrameMemoryStorage&&) = default;
+        ~FrameMemoryStorage();
+
+        /*
+         * aCapacity reserves room for objects expected to grow, see BlockPool::Acquire.
+         */
+        uint8_t* Allocate(size_t aSize, size_t aRealAddress = 0, size_t aCapacity = 0);
+
+        /*
+         * Returns data of the object stored for aRealAddress, nullptr if the frame has no such object of aSize bytes.
+         */
+        const uint8_t* FindData(size_t aRealAddress, size_t aSize) const;
+
+        /*
+         * Returns data of the object stored for aRealAddress regardless of its size, empty if the frame has no such object.
+         */
+        std::span<const uint8_t> FindObject(size_t aRealAddress) const;
+
+        /*
+         * References the block of aData, which is stored in aOwner, and marks it stale in this frame.
+         * Metadata is shared with aOwner, therefore staleness is tracked by the frame and not in Metadata.
+         */
+        void Adopt(const uint8_t* aData, const FrameMemoryStorage& aOwner);
+
+        bool IsStale(const uint8_t* aData) const { return m_staleData.contains(aData); }
+
+        /*
+         * Compares freshly read aData with the block of the same real address in aPrevious.
+         * When they are identical, the fresh block is returned to the pool and the previous block is referenced instead.
+         * Otherwise the changed byte ranges are recorded and the block is marked dirty.
+         * Returns pointer to the data that should be used from now on.
+         */
+        uint8_t* ShareUnchanged(uint8_t* aData, const FrameMemoryStorage* aPrevious);
+
+        /*
+         * Takes over all blocks of aSlice. Used to join storages filled by multiple threads into a single frame.
+         */
+        void Merge(FrameMemoryStorage&& aSlice);
+
+        /*
+         * Byte ranges of the stored object aData which changed against the frame read before this one.
+         * Objects without a counterpart in the previous frame are reported as changed entirely.
+         */
+        std::span<const ChangedRange> GetChangedRanges(const uint8_t* aData) const;
+
+        /*
+         * True when every object was shared from aPrevious and no object disappeared.
+         * Valid only when this frame was read with aPrevious as the previous frame.
+         */
+        bool IsIdenticalTo(const FrameMemoryStorage& aPrevious) const;
+
+        /*
+         * True once any object stored so far differs from the previous frame.
+         */
+        bool HasChanges() const { return !m_changesByAddress.empty(); }
 
         void SetLayoutBase(const std::string& aLayoutType, uint8_t* aBase);
-        uint8_t* GetLayoutBase(const std::string& aLayoutType);
+        const uint8_t* FindLayoutBase(const std::string& aLayoutType) const;
+
+        const FrameBytes& GetBytes() const { return m_totalBytes; }
+
+        /*
+         * Bytes read while reading main layout aLayoutType, including its whole subtree.
+         */
+        void SetLayoutBytes(const std::string& aLayoutType, const FrameBytes& aBytes);
+        const std::unordered_map<std::string, FrameBytes>& GetBytesByLayout() const { return m_bytesByLayout; }
+
+        /*
+         * aSequence is the number of the frame since the start of the main loop.
+         */
+        void SetFrameInfo(size_t aSequence, std::chrono::steady_clock::time_point aTimestamp);
+        size_t GetSequence() const { return m_sequence; }
+        std::chrono::steady_clock::time_point GetTimestamp() const { return m_timestamp; }
     };
 
+    /*
+     * Stored frames, oldest first. Frames are owned by pointer, so a published frame can outlive its eviction in snapshots
+     * taken for update consumers.
+     */
+    using FrameHistory = std::deque<std::shared_ptr<FrameMemoryStorage>>;
+
 }
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "game_enhancer/impl/layout/frame_read_context.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace GE
+{
+    namespace
+    {
+        uint8_t* const kAbortedEntry = reinterpret_cast<uint8_t*>(1);
+    }
+
+    FrameReadContext::FrameReadContext(FrameMemoryStorage& aFrame, const FrameMemoryStorage* aPreviousFrame,
+                                       WorkStealingPool* aPool, BatchReader* aBatchReader)
+        : m_frame(aFrame)
+        , m_previousFrame(aPreviousFrame)
+        , m_pool(aPool)
+        , m_batchReader(aBatchReader)
+    {
+        if (m_pool)
+        {
+            for (size_t i = 0; i < m_pool->GetWorkerCount(); ++i)
+            {
+                m_slices.push_back(std::make_unique<FrameMemoryStorage>());
+            }
+        }
+    }
+
+    void FrameReadContext::SetBudget(std::optional<std::chrono::microseconds> aBudget, const Clock& aClock)
+    {
+        m_clock = &aClock;
+        m_start = aClock.Now();
+        m_budget = aBudget;
+    }
+
+    bool FrameReadContext::Exceeded(Layout::Priority aPriority) const
+    {
+        if (!m_budget || !m_previousFrame || aPriority == Layout::Priority::High)
+        {
+            return false;
+        }
+        auto limit = aPriority == Layout::Priority::Low ? *m_budget * 3 / 4 : *m_budget;
+        return m_clock->Now() - m_start >= limit;
+    }
+
+    bool FrameReadContext::Adopt(const uint8_t* aPreviousData)
+    {
+        {
+            std::scoped_lock lock(m_adoptMutex);
+            if (!m_adopted.insert(aPreviousData).second)
+            {
+                return false;
+            }
+        }
+        GetStorage().Adopt(aPreviousData, *m_previousFrame);
+        return true;
+    }
+
+    FrameMemoryStorage& FrameReadContext::GetStorage()
+    {
+        if (!m_pool)
+        {
+            return m_frame;
+        }
+        auto index = m_pool->CurrentWorkerIndex();
+        return index == 0 ? m_frame : *m_slices[index - 1];
+    }
+
+    uint8_t* FrameReadContext::Claim(size_t aRealAddress)
+    {
+        if (!m_pool)
+        {
+            auto [it, inserted] = m_pointers.try_emplace(aRealAddress, nullptr);
+            return it->second;
+        }
+
+        auto& shard = m_shards[(aRealAddress >> 4) % m_shards.size()];
+        std::atomic<uint8_t*>* entry = nullptr;
+        {
+            std::scoped_lock lock(shard.m_mutex);
+            auto [it, inserted] = shard.m_pointers.try_emplace(aRealAddress, nullptr);
+            if (inserted)
+            {
+                return nullptr;
+            }
+            entry = &it->second;
+        }
+        // The owner only waits for objects below this one, so sleeping here cannot close a cycle of waiting workers
+        if (!m_aborted)
+        {
+            entry->wait(nullptr);
+        }
+        if (m_aborted)
+        {
+            throw std::runtime_error("Frame read aborted");
+        }
+        return entry->load();
+    }
+
+    bool FrameReadContext::TryClaim(size_t aRealAddress, uint8_t*& aResolved)
+    {
+        auto [it, inserted] = m_pointers.try_emplace(aRealAddress, nullptr);
+        aResolved = it->second;
+        return inserted;
+    }
+
+    void FrameReadContext::Publish(size_t aRealAddress, uint8_t* aData)
+    {
+        if (!m_pool)
+        {
+            m_pointers[aRealAddress] = aData;
+            m_pending.erase(aRealAddress);
+            return;
+        }
+        auto& shard = m_shards[(aRealAddress >> 4) % m_shards.size()];
+        std::scoped_lock lock(shard.m_mutex);
+        auto& entry = shard.m_pointers.at(aRealAddress);
+        entry = aData;
+        entry.notify_all();
+    }
+
+    void FrameReadContext::AddPending(PendingPointee& aPointee)
+    {
+        m_pending[aPointee.m_address] = &aPointee;
+    }
+
+    PendingPointee* FrameReadContext::FindPending(size_t aRealAddress) const
+    {
+        auto it = m_pending.find(aRealAddress);
+        return it == m_pending.end() ? nullptr : it->second;
+    }
+
+    void FrameReadContext::Abort()
+    {
+        m_aborted = true;
+        // Objects which will never be published get a placeholder so that their waiters wake up and see the abort
+        for (auto& shard : m_shards)
+        {
+            std::scoped_lock lock(shard.m_mutex);
+            for (auto& [address, entry] : shard.m_pointers)
+            {
+                uint8_t* expected = nullptr;
+                if (entry.compare_exchange_strong(expected, kAbortedEntry))
+                {
+                    entry.notify_all();
+                }
+            }
+        }
+    }
+
+    bool FrameReadContext::HasChanges() const
+    {
+        return m_frame.HasChanges() || std::ranges::any_of(m_slices, [](const auto& aSlice) {
+                   return aSlice->HasChanges();
+               });
+    }
+
+    FrameBytes FrameReadContext::GetBytes() const
+    {
+        auto bytes = m_frame.GetBytes();
+        for (const auto& slice : m_slices)
+        {
+            bytes.m_bytes += slice->GetBytes().m_bytes;
+            bytes.m_freshBytes += slice->GetBytes().m_freshBytes;
+        }
+        return bytes;
+    }
+
+    void FrameReadContext::MergeSlices()
+    {
+        for (auto& slice : m_slices)
+        {
+            m_frame.Merge(std::move(*slice));
+        }
+    }
+}
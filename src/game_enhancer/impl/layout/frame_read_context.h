@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "game_enhancer/batch_reader.h"
+#include "game_enhancer/clock.h"
+#include "game_enhancer/impl/layout/frame_memory_storage.h"
+#include "game_enhancer/memory_layout_builder.h"
+#include "game_enhancer/impl/utils/work_stealing_pool.h"
+
+namespace GE
+{
+    /*
+     * Pointee whose read was queued into a BatchReader and still waits for completion.
+     * Only the owner reads the object, other referrers get the pointer once the owner finishes.
+     */
+    struct PendingPointee
+    {
+        size_t* m_slot = nullptr;
+        size_t m_address = 0;
+        const Layout* m_layout = nullptr;
+        uint8_t* m_data = nullptr;
+        bool m_owner = false;
+        bool m_finished = false;
+    };
+
+    /*
+     * State of a single frame read. Resolves every real address to exactly one stored object, even when the frame is read
+     * by multiple workers. Each worker allocates into its own slice which gets merged into the frame afterwards.
+     */
+    class FrameReadContext
+    {
+        struct Shard
+        {
+            std::mutex m_mutex;
+            std::unordered_map<size_t, std::atomic<uint8_t*>> m_pointers;
+        };
+
+        FrameMemoryStorage& m_frame;
+        const FrameMemoryStorage* m_previousFrame;
+        WorkStealingPool* m_pool;
+        BatchReader* m_batchReader;
+
+        std::vector<std::unique_ptr<FrameMemoryStorage>> m_slices;
+        std::unordered_map<size_t, uint8_t*> m_pointers;
+        std::unordered_map<size_t, PendingPointee*> m_pending;
+        std::array<Shard, 16> m_shards;
+        std::atomic<bool> m_aborted = false;
+
+        const Clock* m_clock = nullptr;
+        Clock::TimePoint m_start;
+        std::optional<std::chrono::microseconds> m_budget;
+        std::mutex m_adoptMutex;
+        std::unordered_set<const uint8_t*> m_adopted;
+
+    public:
+        FrameReadContext(FrameMemoryStorage& aFrame, const FrameMemoryStorage* aPreviousFrame, WorkStealingPool* aPool = nullptr,
+                         BatchReader* aBatchReader = nullptr);
+
+        FrameMemoryStorage& GetFrame() { return m_frame; }
+
+        /*
+         * Starts measuring the frame against aBudget on aClock, nullopt means unlimited.
+         */
+        void SetBudget(std::optional<std::chrono::microseconds> aBudget, const Clock& aClock);
+
+        /*
+         * True when data of aPriority should be reused from the previous frame instead of being read.
+         */
+        bool Exceeded(Layout::Priority aPriority) const;
+
+        /*
+         * Registers aPreviousData of the previous frame as part of this frame.
+         * Returns false when it was already adopted, its subtree does not need to be visited again.
+         */
+        bool Adopt(const uint8_t* aPreviousData);
+
+        size_t GetAdoptedCount() const { return m_adopted.size(); }
+
+        /*
+         * Storage the calling thread should allocate into.
+         */
+        FrameMemoryStorage& GetStorage();
+
+        const FrameMemoryStorage* GetPreviousFrame() const { return m_previousFrame; }
+
+        WorkStealingPool* GetPool() const { return m_pool; }
+
+        /*
+         * Batched reads are used only when the frame is read by a single thread.
+         */
+        BatchReader* GetBatchReader() const { return m_pool ? nullptr : m_batchReader; }
+
+        /*
+         * Returns the stored object for aRealAddress when it was already read.
+         * Returns nullptr when the calling thread became responsible for reading it and must call Publish afterwards.
+         * If another worker is reading the object, sleeps until it gets published.
+         */
+        uint8_t* Claim(size_t aRealAddress);
+
+        /*
+         * Single threaded variant of Claim used for deferred reads. Returns false when aRealAddress is already claimed,
+         * aResolved then receives the stored object or nullptr when it is not published yet.
+         */
+        bool TryClaim(size_t aRealAddress, uint8_t*& aResolved);
+
+        void Publish(size_t aRealAddress, uint8_t* aData);
+
+        void AddPending(PendingPointee& aPointee);
+
+        /*
+         * Returns the pending owner of aRealAddress, nullptr if the object is not waiting for a batched read.
+         */
+        PendingPointee* FindPending(size_t aRealAddress) const;
+
+        /*
+         * Wakes up all workers waiting for a claimed object, they throw instead of returning it.
+         * Called when the read failed and the frame is dropped.
+         */
+        void Abort();
+
+        /*
+         * Moves blocks of the worker slices into the frame, ordered by worker index.
+         */
+        void MergeSlices();
+
+        /*
+         * True once any object stored so far by the frame or one of its slices differs from the previous frame.
+         */
+        bool HasChanges() const;
+
+        /*
+         * Bytes stored so far by the frame and all of its slices.
+         */
+        FrameBytes GetBytes() const;
+    };
+}
@@ -2,7 +2,9 @@
 
 #include "game_enhancer/impl/layout/memory_layout_builder.h"
 
+#include <format>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 namespace GE
@@ -87,6 +89,68 @@ namespace GE
         return *this;
     }
 
+    Layout::Builder& BuilderImpl::AddWalk(std::variant<size_t, PMA::MultiLevelPointer>& aOffsetOrMlp,
+                                          const std::string& aNodeType, Layout::Walk aWalk)
+    {
+        if (aWalk.m_maxItems == 0)
+        {
+            throw std::runtime_error(std::format("Walk of '{}' has to collect at least one node", aNodeType));
+        }
+        m_pointerOffsets.push_back({GetMlp(aOffsetOrMlp), 1, [aNodeType](void*) {
+                                        return aNodeType;
+                                    }});
+        m_pointerOffsets.back().m_walk = std::move(aWalk);
+        return *this;
+    }
+
+    Layout::Builder& BuilderImpl::AddListWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp,
+                                              const std::string& aNodeType, size_t aNextOffset, size_t aMaxItems)
+    {
+        return AddWalk(aOffsetOrMlp, aNodeType, {{aNextOffset}, aMaxItems});
+    }
+
+    Layout::Builder& BuilderImpl::AddBucketWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp,
+                                                const std::string& aNodeType, size_t aBucketCount, size_t aNextOffset,
+                                                size_t aMaxItems)
+    {
+        if (aBucketCount == 0)
+        {
+            throw std::runtime_error(std::format("Bucket walk of '{}' needs at least one bucket", aNodeType));
+        }
+        return AddWalk(aOffsetOrMlp, aNodeType, {{aNextOffset}, aMaxItems, aBucketCount});
+    }
+
+    Layout::Builder& BuilderImpl::AddTreeWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp,
+                                              const std::string& aNodeType, std::vector<size_t> aChildOffsets, size_t aMaxItems)
+    {
+        return AddWalk(aOffsetOrMlp, aNodeType, {std::move(aChildOffsets), aMaxItems});
+    }
+
+    Layout::Builder& BuilderImpl::SetPointerPriority(Layout::Priority aPriority)
+    {
+        if (m_pointerOffsets.empty())
+        {
+            throw std::runtime_error("SetPointerPriority called before any pointer was added");
+        }
+        m_pointerOffsets.back().m_priority = aPriority;
+        return *this;
+    }
+
+    Layout::Builder& BuilderImpl::SetAppendOnly()
+    {
+        if (m_pointerOffsets.empty())
+        {
+            throw std::runtime_error("SetAppendOnly called before any pointer was added");
+        }
+        auto& ptr = m_pointerOffsets.back();
+        if (ptr.m_walk || !std::holds_alternative<Layout::DataSizeProvider>(ptr.m_pointeeType))
+        {
+            throw std::runtime_error("SetAppendOnly needs a pointer to data of dynamic size");
+        }
+        ptr.m_appendOnly = true;
+        return *this;
+    }
+
     std::unique_ptr<Layout> BuilderImpl::Build()
     {
         return std::make_unique<LayoutImpl>(m_consecutive, m_totalSize, std::move(m_pointerOffsets));
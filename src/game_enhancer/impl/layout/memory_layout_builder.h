@@ -30,6 +30,9 @@ namespace GE
         size_t m_totalSize = 0;
         std::vector<Layout::Ptr> m_pointerOffsets;
 
+        Layout::Builder& AddWalk(std::variant<size_t, PMA::MultiLevelPointer>& aOffsetOrMlp, const std::string& aNodeType,
+                                 Layout::Walk aWalk);
+
     public:
         BuilderImpl(bool aConsecutive = true);
 
@@ -44,6 +47,17 @@ namespace GE
         Layout::Builder& AddPointerOffsets(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp,
                                            const std::function<size_t(void*)>& aDynamicSize, size_t aCount) override;
 
+        Layout::Builder& AddListWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp, const std::string& aNodeType,
+                                     size_t aNextOffset, size_t aMaxItems) override;
+        Layout::Builder& AddBucketWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp, const std::string& aNodeType,
+                                       size_t aBucketCount, size_t aNextOffset, size_t aMaxItems) override;
+        Layout::Builder& AddTreeWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp, const std::string& aNodeType,
+                                     std::vector<size_t> aChildOffsets, size_t aMaxItems) override;
+
+        Layout::Builder& SetPointerPriority(Layout::Priority aPriority) override;
+
+        Layout::Builder& SetAppendOnly() override;
+
         std::unique_ptr<Layout> Build() override;
     };
 
@@ -1,18 +1,32 @@
 #include "game_enhancer/impl/memory_processor.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <ranges>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "game_enhancer/impl/data_accessor.h"
+#include "game_enhancer/impl/layout/frame_history.h"
+#include "game_enhancer/impl/layout/frame_read_context.h"
+#include "game_enhancer/log.h"
 #include "game_enhancer/memory_layout_builder.h"
+#include "game_enhancer/tracer.h"
 #include "spdlog/sinks/null_sink.h"
 
 namespace GE
 {
+    namespace
+    {
+        // Walk results are stored next to their first node, user space addresses never have the top bit set
+        constexpr size_t kWalkAddressTag = size_t{1} << 63;
+    }
+
     void MemoryProcessorImpl::EnablerImpl::EnsureSubsequent(const LayoutId& aLayout)
     {
         auto& order = m_memProc.m_mainLayoutOrder;
@@ -56,11 +70,55 @@ namespace GE
         l.m_active = false;
     }
 
-    void MemoryProcessorImpl::ReadMainLayouts()
+    bool MemoryProcessorImpl::TargetAdvanced()
+    {
+        if (!m_deduplicate || !m_tickProbe || m_storedFrames->size() < m_framesToKeep)
+        {
+            return true;
+        }
+        TraceSpan probeSpan("TickProbe");
+        m_currentTick.assign(m_tickProbe->m_size, 0);
+        auto address = m_tickProbe->m_locator(m_memoryAccess);
+        if (m_memoryAccess->Read(address, m_currentTick.data(), m_currentTick.size()) != m_currentTick.size())
+        {
+            m_lastTick.clear();
+            return true;
+        }
+        if (m_currentTick == m_lastTick)
+        {
+            GE_LOG_TRACE(m_frameLog, "Tick probe unchanged, skipping frame");
+            return false;
+        }
+        std::swap(m_lastTick, m_currentTick);
+        return true;
+    }
+
+    bool MemoryProcessorImpl::ReadMainLayouts()
     {
-        m_logger->trace("ReadMainLayouts called");
-        FrameMemoryStorage& currentFrameStorage = m_storedFrames->emplace_back(FrameMemoryStorage{});
-        std::unordered_map<size_t, uint8_t*> pointerMap;
+        GE_LOG_TRACE(m_frameLog, "ReadMainLayouts called");
+        m_appendTracker.NextFrame();
+        const FrameMemoryStorage* previousFrame = m_storedFrames->empty() ? nullptr : m_storedFrames->back().get();
+        FrameMemoryStorage& currentFrameStorage = *m_storedFrames->emplace_back(std::make_shared<FrameMemoryStorage>(m_blockPool));
+        currentFrameStorage.SetFrameInfo(m_frameSequence++, m_clock->Now());
+        FrameReadContext context(currentFrameStorage, previousFrame, m_walkerPool.get(), m_batchReader.get());
+        context.SetBudget(m_frameBudget, *m_clock);
+        std::vector<MainLayout*> readLayouts;
+        // Enablers are postponed while the frame may still turn out identical, they see the data they already saw then
+        const bool mayDrop = m_deduplicate && !m_tickProbe && previousFrame;
+        std::vector<size_t> postponedEnablers;
+        auto runEnabler = [this](size_t aIndex) {
+            const auto& layoutId = m_mainLayoutOrder[aIndex];
+            TraceSpan enablerSpan("Enabler", layoutId);
+            EnablerImpl enabler(*this, aIndex);
+            (*m_mainLayouts[layoutId].m_callbacks.m_enabler)(*m_dataAccessor, enabler);
+        };
+        auto runPostponedEnablers = [&]() {
+            for (auto index : postponedEnablers)
+            {
+                runEnabler(index);
+            }
+            postponedEnablers.clear();
+        };
         for (int i = 0; i < m_mainLayoutOrder.size(); ++i)
         {
             const auto& layoutId = m_mainLayoutOrder[i];
@@ -69,26 +127,100 @@ namespace GE
             {
                 continue;
             }
+            TraceSpan mainLayoutSpan("MainLayout", layoutId);
+            auto bytesBefore = context.GetBytes();
 
-            auto baseAddress = layout.m_callbacks.m_baseLocator(m_memoryAccess, layout.m_dataFromEnabler);
-            currentFrameStorage.SetLayoutBase(layoutId, ReadLayout(layoutId, baseAddress, pointerMap, currentFrameStorage));
+            const uint8_t* previousBase = previousFrame ? previousFrame->FindLayoutBase(layoutId) : nullptr;
+            if (previousBase && context.Exceeded(layout.m_callbacks.m_priority))
+            {
+                AdoptSubtree(m_layouts[layoutId].get(), previousBase, context);
+                currentFrameStorage.SetLayoutBase(layoutId, const_cast<uint8_t*>(previousBase));
+            }
+            else
+            {
+                PMA::MemoryAddress baseAddress = 0;
+                {
+                    TraceSpan locatorSpan("BaseLocator", layoutId);
+                    baseAddress = layout.m_callbacks.m_baseLocator(m_memoryAccess, layout.m_dataFromEnabler);
+                }
+                TraceSpan readSpan("ReadLayout", layoutId);
+                currentFrameStorage.SetLayoutBase(layoutId, ReadLayout(layoutId, baseAddress, context));
+            }
+            auto bytesAfter = context.GetBytes();
+            currentFrameStorage.SetLayoutBytes(layoutId, {bytesAfter.m_bytes - bytesBefore.m_bytes,
+                                                          bytesAfter.m_freshBytes - bytesBefore.m_freshBytes});
             layout.m_consecutiveFrames++;
+            readLayouts.push_back(&layout);
 
             if (layout.m_callbacks.m_enabler)
             {
-                EnablerImpl enabler(*this, i);
-                (*layout.m_callbacks.m_enabler)(*m_dataAccessor, enabler);
+                if (mayDrop && !context.HasChanges())
+                {
+                    postponedEnablers.push_back(i);
+                }
+                else
+                {
+                    runPostponedEnablers();
+                    runEnabler(i);
+                }
             }
         }
-        if (m_storedFrames->size() > m_framesToKeep)
+        context.MergeSlices();
+        if (context.GetAdoptedCount() > 0)
+        {
+            GE_LOG_DEBUG(m_frameLog, "Frame budget exceeded, {} objects reused from the previous frame",
+                         context.GetAdoptedCount());
+        }
+        if (mayDrop && currentFrameStorage.IsIdenticalTo(*previousFrame))
+        {
+            GE_LOG_TRACE(m_frameLog, "Frame identical to the previous one, dropping it");
+            for (auto* layout : readLayouts)
+            {
+                layout->m_consecutiveFrames--;
+            }
+            m_storedFrames->pop_back();
+            // Keeps sequences of stored frames consecutive, see CountRetainedBytes
+            --m_frameSequence;
+            return false;
+        }
+        // Frame differs only after the last enabler, or in the number of objects
+        runPostponedEnablers();
+        ApplyRetention(*m_storedFrames, m_historyDepth, m_historyTiers);
+        EnforceMemoryBudget();
+        return true;
+    }
+
+    void MemoryProcessorImpl::EnforceMemoryBudget()
+    {
+        auto evicted = m_memoryBudget ? ApplyMemoryBudget(*m_storedFrames, m_historyDepth, *m_memoryBudget) : 0;
+        auto retained = CountRetainedBytes(*m_storedFrames);
+        if (m_memoryBudget && (evicted > 0 || retained.m_bytes > *m_memoryBudget) &&
+            m_storedFrames->size() < m_lowestReportedDepth)
         {
-            m_storedFrames->pop_front();
+            m_lowestReportedDepth = m_storedFrames->size();
+            GE_LOG_WARN(m_frameLog, "Memory budget of {} bytes exceeded, history lowered to {} frames holding {} bytes",
+                        *m_memoryBudget, m_storedFrames->size(), retained.m_bytes);
+            std::vector<std::pair<size_t, const std::string*>> layouts;
+            for (const auto& [layout, bytes] : retained.m_bytesByLayout)
+            {
+                layouts.emplace_back(bytes, &layout);
+            }
+            std::ranges::sort(layouts, std::greater{});
+            for (const auto& [bytes, layout] : layouts | std::views::take(3))
+            {
+                GE_LOG_WARN(m_frameLog, "Main layout '{}' retains {} bytes", *layout, bytes);
+            }
         }
+        std::scoped_lock lock(m_usageMutex);
+        m_memoryUsage.m_bytes = retained.m_bytes;
+        m_memoryUsage.m_peakBytes = std::max(m_memoryUsage.m_peakBytes, retained.m_bytes);
+        m_memoryUsage.m_frames = m_storedFrames->size();
+        m_memoryUsage.m_bytesByLayout = std::move(retained.m_bytesByLayout);
     }
 
     void MemoryProcessorImpl::Update()
     {
-        m_logger->trace("Update called");
+        GE_LOG_TRACE(m_frameLog, "Update called");
         if (m_storedFrames->size() < m_framesToKeep)
         {
             return;
@@ -103,100 +235,648 @@ namespace GE
             }
         }
 
+        if (!m_updateCallback)
+        {
+            return;
+        }
         try
         {
+            TraceSpan updateSpan("UpdateCallback");
             m_updateCallback(*m_dataAccessor);
             m_consecutiveFailedUpdates = 0;
         }
         catch (const std::exception& e)
         {
-            m_logger->error("Error in Update callback: {}", e.what());
+            GE_LOG_ERROR(m_frameLog, "Error in Update callback: {}", e.what());
             if (++m_consecutiveFailedUpdates == 10)
             {
-                m_logger->error("Too many consecutive errors in Update callback. Stopping MemoryProcessor.");
+                GE_LOG_ERROR(m_frameLog, "Too many consecutive errors in Update callback. Stopping MemoryProcessor.");
                 RequestStop();
             }
         }
     }
 
+    void MemoryProcessorImpl::DispatchConsumers()
+    {
+        auto now = m_clock->Now();
+        // Snapshot holds only frame pointers, frames evicted meanwhile stay alive until the consumers finish
+        std::shared_ptr<const FrameHistory> snapshot;
+        for (auto& state : m_consumers)
+        {
+            if (now < state->m_nextDue || m_storedFrames->size() < state->m_consumer.m_framesRequired)
+            {
+                continue;
+            }
+            if (state->m_busy.load(std::memory_order_acquire))
+            {
+                GE_LOG_TRACE(m_frameLog, "Update consumer still running, skipping dispatch");
+                continue;
+            }
+            if (!snapshot)
+            {
+                snapshot = std::make_shared<const FrameHistory>(*m_storedFrames);
+            }
+            state->m_nextDue = now + state->m_consumer.m_period;
+            state->m_busy.store(true, std::memory_order_relaxed);
+            m_consumerPool->Submit([this, consumer = state.get(), snapshot]() {
+                RunConsumer(*consumer, snapshot);
+            });
+        }
+    }
+
+    void MemoryProcessorImpl::RunConsumer(ConsumerState& aState, const std::shared_ptr<const FrameHistory>& aFrames)
+    {
+        try
+        {
+            TraceSpan consumerSpan("UpdateConsumer");
+            DataAccessorImpl accessor(aFrames);
+            aState.m_consumer.m_callback(accessor);
+            aState.m_consecutiveFailures = 0;
+        }
+        catch (const std::exception& e)
+        {
+            GE_LOG_ERROR(m_frameLog, "Error in Update consumer: {}", e.what());
+            if (++aState.m_consecutiveFailures == 10)
+            {
+                GE_LOG_ERROR(m_frameLog, "Too many consecutive errors in Update consumer. Stopping MemoryProcessor.");
+                RequestStop();
+            }
+        }
+        aState.m_busy.store(false, std::memory_order_release);
+    }
+
+    void MemoryProcessorImpl::WaitForConsumers()
+    {
+        if (!m_consumerPool)
+        {
+            return;
+        }
+        m_consumerPool->HelpUntil([this]() {
+            return std::ranges::none_of(m_consumers, [](const auto& aState) {
+                return aState->m_busy.load(std::memory_order_acquire);
+            });
+        });
+    }
+
+    std::chrono::milliseconds MemoryProcessorImpl::GetRefreshRate() const
+    {
+        if (m_updateCallback || m_consumers.empty())
+        {
+            return std::chrono::milliseconds(m_refreshRateMs);
+        }
+        return std::ranges::min(m_consumers | std::views::transform([](const auto& aState) {
+                                    return aState->m_consumer.m_period;
+                                }));
+    }
+
     uint8_t* MemoryProcessorImpl::Allocate(size_t aBytes, size_t aFromAddress, FrameMemoryStorage& aCurrentFrameStorage)
     {
-        uint8_t* storagePtr = aCurrentFrameStorage.Allocate(aBytes);
-        GetMetadata(storagePtr)->m_realAddress = aFromAddress;
-        return storagePtr;
+        return aCurrentFrameStorage.Allocate(aBytes, aFromAddress);
     }
 
-    uint8_t* MemoryProcessorImpl::ReadData(size_t aBytes, size_t aFromAddress, FrameMemoryStorage& aCurrentFrameStorage)
+    uint8_t* MemoryProcessorImpl::ReadData(size_t aBytes, size_t aFromAddress, FrameMemoryStorage& aCurrentFrameStorage,
+                                           BatchReader* aBatchReader)
     {
         uint8_t* storagePtr = Allocate(aBytes, aFromAddress, aCurrentFrameStorage);
-        GetMetadata(storagePtr)->m_bytesRead = m_memoryAccess->Read(aFromAddress, storagePtr, aBytes);
+        if (aBatchReader)
+        {
+            aBatchReader->Queue(aFromAddress, storagePtr, aBytes, &GetMetadata(storagePtr)->m_bytesRead);
+        }
+        else
+        {
+            GetMetadata(storagePtr)->m_bytesRead = m_memoryAccess->Read(aFromAddress, storagePtr, aBytes);
+        }
         return storagePtr;
     }
 
-    // TODO refactor this + Layout logic
-    uint8_t* MemoryProcessorImpl::ReadLayout(const LayoutId& aLayoutId, size_t aFromAddress,
-                                             std::unordered_map<size_t, uint8_t*>& aPointerMap,
-                                             FrameMemoryStorage& aCurrentFrameStorage)
+    uint8_t* MemoryProcessorImpl::ReadAppendOnlyData(size_t aBytes, size_t aFromAddress, FrameReadContext& aContext)
+    {
+        auto& storage = aContext.GetStorage();
+        const auto* previousFrame = aContext.GetPreviousFrame();
+        auto previous = previousFrame ? previousFrame->FindObject(aFromAddress) : std::span<const uint8_t>{};
+        if (previous.empty() || GetMetadata(previous.data())->m_bytesRead != previous.size())
+        {
+            return ReadData(aBytes, aFromAddress, storage);
+        }
+        if (aBytes < previous.size())
+        {
+            m_appendTracker.Observe(aFromAddress, false);
+            return ReadData(aBytes, aFromAddress, storage);
+        }
+        // Only growth takes the appended read, an object of the same size could have been edited anywhere. Unchanged
+        // objects keep their streak, e.g. a log between two appends.
+        if (aBytes == previous.size())
+        {
+            auto* data = ReadData(aBytes, aFromAddress, storage);
+            if (GetMetadata(data)->m_bytesRead != aBytes || std::memcmp(data, previous.data(), aBytes) != 0)
+            {
+                m_appendTracker.Observe(aFromAddress, false);
+            }
+            return data;
+        }
+        // Growing objects get room to grow further, their blocks are then reused by the following frames
+        auto* data = storage.Allocate(aBytes, aFromAddress, aBytes + aBytes / 4);
+        if (m_appendTracker.ShouldReadAppended(aFromAddress))
+        {
+            auto guardStart = previous.size() - std::min(AppendTracker::kGuardBytes, previous.size());
+            auto bytes = aBytes - guardStart;
+            if (m_memoryAccess->Read(aFromAddress + guardStart, data + guardStart, bytes) == bytes &&
+                std::memcmp(data + guardStart, previous.data() + guardStart, previous.size() - guardStart) == 0)
+            {
+                std::memcpy(data, previous.data(), guardStart);
+                GetMetadata(data)->m_bytesRead = aBytes;
+                return data;
+            }
+        }
+        GetMetadata(data)->m_bytesRead = m_memoryAccess->Read(aFromAddress, data, aBytes);
+        m_appendTracker.Observe(aFromAddress, GetMetadata(data)->m_bytesRead == aBytes &&
+                                                  std::memcmp(data, previous.data(), previous.size()) == 0);
+        return data;
+    }
+
+    uint8_t* MemoryProcessorImpl::ReadPointee(const Layout::Ptr& aPtr, size_t aFromAddress, uint8_t* aParent,
+                                              FrameReadContext& aContext)
+    {
+        if (auto* resolved = aContext.Claim(aFromAddress))
+        {
+            return resolved;
+        }
+        uint8_t* pointee = nullptr;
+        try
+        {
+            if (std::holds_alternative<Layout::LayoutIdProvider>(aPtr.m_pointeeType))
+            {
+                auto& layoutIdProvider = std::get<Layout::LayoutIdProvider>(aPtr.m_pointeeType);
+                pointee = ReadLayout(layoutIdProvider(aParent), aFromAddress, aContext);
+            }
+            else
+            {
+                auto& dataSizeProvider = std::get<Layout::DataSizeProvider>(aPtr.m_pointeeType);
+                auto& storage = aContext.GetStorage();
+                auto bytes = dataSizeProvider(aParent);
+                pointee = storage.ShareUnchanged(aPtr.m_appendOnly ? ReadAppendOnlyData(bytes, aFromAddress, aContext)
+                                                                   : ReadData(bytes, aFromAddress, storage),
+                                                 aContext.GetPreviousFrame());
+            }
+        }
+        catch (...)
+        {
+            aContext.Abort();
+            throw;
+        }
+        aContext.Publish(aFromAddress, pointee);
+        return pointee;
+    }
+
+    void MemoryProcessorImpl::QueuePointee(const Layout::Ptr& aPtr, size_t aFromAddress, uint8_t* aParent, size_t* aSlot,
+                                           FrameReadContext& aContext, std::vector<PendingPointee>& aPending)
+    {
+        uint8_t* resolved = nullptr;
+        if (!aContext.TryClaim(aFromAddress, resolved))
+        {
+            // Already pending pointees are assigned once their owner finishes
+            aPending.push_back({aSlot, aFromAddress, nullptr, resolved, false});
+            return;
+        }
+        auto& storage = aContext.GetStorage();
+        if (std::holds_alternative<Layout::LayoutIdProvider>(aPtr.m_pointeeType))
+        {
+            auto& layoutIdProvider = std::get<Layout::LayoutIdProvider>(aPtr.m_pointeeType);
+            auto* layout = m_layouts[layoutIdProvider(aParent)].get();
+            auto* data = layout->IsConsecutive()
+                             ? ReadData(layout->GetTotalSize(), aFromAddress, storage, aContext.GetBatchReader())
+                             : Allocate(layout->GetTotalSize(), aFromAddress, storage);
+            aPending.push_back({aSlot, aFromAddress, layout, data, true});
+        }
+        else
+        {
+            auto& dataSizeProvider = std::get<Layout::DataSizeProvider>(aPtr.m_pointeeType);
+            aPending.push_back({aSlot, aFromAddress, nullptr,
+                                ReadData(dataSizeProvider(aParent), aFromAddress, storage, aContext.GetBatchReader()), true});
+        }
+    }
+
+    uint8_t* MemoryProcessorImpl::FinishPointee(PendingPointee& aPointee, FrameReadContext& aContext)
+    {
+        if (!aPointee.m_owner)
+        {
+            auto* data = aPointee.m_data ? aPointee.m_data : aContext.Claim(aPointee.m_address);
+            if (!data)
+            {
+                // Owner was queued by one of the parents and is not finished yet
+                if (auto* owner = aContext.FindPending(aPointee.m_address))
+                {
+                    data = FinishPointee(*owner, aContext);
+                }
+            }
+            *aPointee.m_slot = reinterpret_cast<size_t>(data);
+            return data;
+        }
+        if (aPointee.m_finished)
+        {
+            return aContext.Claim(aPointee.m_address);
+        }
+        aPointee.m_finished = true;
+        auto* data = aPointee.m_layout ? ResolvePointers(*aPointee.m_layout, aPointee.m_address, aPointee.m_data, aContext)
+                                       : aContext.GetStorage().ShareUnchanged(aPointee.m_data, aContext.GetPreviousFrame());
+        aContext.Publish(aPointee.m_address, data);
+        *aPointee.m_slot = reinterpret_cast<size_t>(data);
+        return data;
+    }
+
+    void MemoryProcessorImpl::FinishPointees(std::vector<PendingPointee>& aPending, FrameReadContext& aContext)
+    {
+        for (auto& pointee : aPending)
+        {
+            if (pointee.m_owner)
+            {
+                aContext.AddPending(pointee);
+            }
+        }
+        aContext.GetBatchReader()->Flush();
+        for (auto& pointee : aPending | std::views::filter(&PendingPointee::m_owner))
+        {
+            FinishPointee(pointee, aContext);
+        }
+        for (auto& pointee : aPending | std::views::filter(std::not_fn(&PendingPointee::m_owner)))
+        {
+            FinishPointee(pointee, aContext);
+        }
+    }
+
+    uint8_t* MemoryProcessorImpl::ReadWalk(const Layout::Ptr& aPtr, size_t aFromAddress, uint8_t* aParent,
+                                           FrameReadContext& aContext)
+    {
+        const auto walkAddress = aFromAddress | kWalkAddressTag;
+        if (auto* resolved = aContext.Claim(walkAddress))
+        {
+            return resolved;
+        }
+        uint8_t* walk = nullptr;
+        try
+        {
+            const auto& walkInfo = *aPtr.m_walk;
+            const auto* layout = GetPointeeLayout(aPtr, aParent);
+            if (!layout->IsConsecutive() ||
+                std::ranges::any_of(walkInfo.m_links, [layout](size_t aLink) {
+                    return aLink + sizeof(size_t) > layout->GetTotalSize();
+                }))
+            {
+                throw std::runtime_error("Walked nodes have to be consecutive and contain their links");
+            }
+
+            std::vector<size_t> roots{aFromAddress};
+            if (walkInfo.m_buckets)
+            {
+                roots.assign(walkInfo.m_buckets, 0);
+                auto bytes = roots.size() * sizeof(size_t);
+                size_t bytesRead = 0;
+                if (auto* batchReader = aContext.GetBatchReader())
+                {
+                    batchReader->Queue(aFromAddress, roots.data(), bytes, &bytesRead);
+                    batchReader->Flush();
+                }
+                else
+                {
+                    bytesRead = m_memoryAccess->Read(aFromAddress, roots.data(), bytes);
+                }
+                if (bytesRead != bytes)
+                {
+                    roots.clear();
+                }
+            }
+
+            // Nodes are read level by level, the next nodes of all chains are known before any of them is read
+            std::vector<WalkItem> items;
+            std::vector<WalkItem> level;
+            std::unordered_set<size_t> visited;
+            auto enqueue = [&](size_t aAddress, size_t aChain, std::vector<WalkItem>& aLevel) {
+                if (aAddress && items.size() + aLevel.size() < walkInfo.m_maxItems && visited.insert(aAddress).second)
+                {
+                    aLevel.push_back({aAddress, aChain});
+                }
+            };
+            for (size_t chain = 0; chain < roots.size(); ++chain)
+            {
+                enqueue(roots[chain], chain, level);
+            }
+            while (!level.empty())
+            {
+                ReadWalkLevel(aPtr, level, aParent, aContext);
+                std::vector<WalkItem> next;
+                for (const auto& item : level)
+                {
+                    if (!item.m_node)
+                    {
+                        continue;
+                    }
+                    items.push_back(item);
+                    // Links are not part of the node layout, they still hold addresses of the target process
+                    for (auto link : walkInfo.m_links)
+                    {
+                        enqueue(*reinterpret_cast<const size_t*>(item.m_node + link), item.m_chain, next);
+                    }
+                }
+                level = std::move(next);
+            }
+            std::ranges::stable_sort(items, {}, &WalkItem::m_chain);
+
+            auto& storage = aContext.GetStorage();
+            auto bytes = (items.size() + 1) * sizeof(size_t);
+            walk = storage.Allocate(bytes, walkAddress);
+            GetMetadata(walk)->m_bytesRead = bytes;
+            auto* nodes = reinterpret_cast<size_t*>(walk);
+            nodes[0] = items.size();
+            for (size_t i = 0; i < items.size(); ++i)
+            {
+                nodes[i + 1] = items[i].m_node;
+            }
+            walk = storage.ShareUnchanged(walk, aContext.GetPreviousFrame());
+        }
+        catch (...)
+        {
+            aContext.Abort();
+            throw;
+        }
+        aContext.Publish(walkAddress, walk);
+        return walk;
+    }
+
+    void MemoryProcessorImpl::ReadWalkLevel(const Layout::Ptr& aPtr, std::vector<WalkItem>& aLevel, uint8_t* aParent,
+                                            FrameReadContext& aContext)
+    {
+        if (aContext.GetBatchReader())
+        {
+            // Reads of the whole level overlap, each chain costs one round trip per node instead of all of them
+            std::vector<PendingPointee> pending;
+            for (auto& item : aLevel)
+            {
+                QueuePointee(aPtr, item.m_address, aParent, &item.m_node, aContext, pending);
+            }
+            FinishPointees(pending, aContext);
+            return;
+        }
+        auto readItems = [&](size_t aBegin, size_t aEnd) {
+            for (size_t i = aBegin; i < aEnd; ++i)
+            {
+                aLevel[i].m_node = reinterpret_cast<size_t>(ReadPointee(aPtr, aLevel[i].m_address, aParent, aContext));
+            }
+        };
+        auto* pool = aContext.GetPool();
+        if (!pool || aLevel.size() < 2)
+        {
+            readItems(0, aLevel.size());
+            return;
+        }
+        const size_t chunk = std::max<size_t>(1, aLevel.size() / (4 * (pool->GetWorkerCount() + 1)));
+        TaskGroup group(*pool);
+        for (size_t begin = 0; begin < aLevel.size(); begin += chunk)
+        {
+            group.Run([&readItems, begin, end = std::min(begin + chunk, aLevel.size())]() {
+                readItems(begin, end);
+            });
+        }
+        group.Wait();
+    }
+
+    uint8_t* MemoryProcessorImpl::ReadLayout(const LayoutId& aLayoutId, size_t aFromAddress, FrameReadContext& aContext)
     {
         auto& layout = m_layouts[aLayoutId];
         uint8_t* storagePtr = nullptr;
         if (layout->IsConsecutive())
         {
-            storagePtr = ReadData(layout->GetTotalSize(), aFromAddress, aCurrentFrameStorage);
+            auto* batchReader = aContext.GetBatchReader();
+            storagePtr = ReadData(layout->GetTotalSize(), aFromAddress, aContext.GetStorage(), batchReader);
+            if (batchReader)
+            {
+                batchReader->Flush();
+            }
         }
         else
         {
-            storagePtr = Allocate(layout->GetTotalSize(), aFromAddress, aCurrentFrameStorage);
+            storagePtr = Allocate(layout->GetTotalSize(), aFromAddress, aContext.GetStorage());
+        }
+        return ResolvePointers(*layout, aFromAddress, storagePtr, aContext);
+    }
+
+    const Layout* MemoryProcessorImpl::GetPointeeLayout(const Layout::Ptr& aPtr, const uint8_t* aParent)
+    {
+        if (!std::holds_alternative<Layout::LayoutIdProvider>(aPtr.m_pointeeType))
+        {
+            return nullptr;
+        }
+        auto& layoutIdProvider = std::get<Layout::LayoutIdProvider>(aPtr.m_pointeeType);
+        return m_layouts[layoutIdProvider(const_cast<uint8_t*>(aParent))].get();
+    }
+
+    void MemoryProcessorImpl::AdoptSubtree(const Layout* aLayout, const uint8_t* aPreviousData, FrameReadContext& aContext)
+    {
+        if (!aContext.Adopt(aPreviousData) || !aLayout)
+        {
+            return;
         }
-        size_t localOffset = 0;
-        for (const auto& ptr : layout->GetPointerOffsets())
+        // Pointers of the previous frame are already translated, they lead to objects of the previous frame
+        size_t slot = 0;
+        for (const auto& ptr : aLayout->GetPointerOffsets())
         {
+            auto base = aLayout->IsConsecutive() ? ptr.m_mlp.front() : slot;
+            slot += ptr.m_count * sizeof(size_t);
             for (size_t i = 0; i < ptr.m_count; ++i)
             {
-                size_t* castedPtr = nullptr;
-                if (layout->IsConsecutive())
+                if (auto pointee = *reinterpret_cast<const size_t*>(aPreviousData + base + i * sizeof(size_t)))
                 {
-                    localOffset = ptr.m_mlp.front() + i * sizeof(size_t);
-                    castedPtr = reinterpret_cast<size_t*>(storagePtr + localOffset);
-                    if (*castedPtr == 0)
-                    {
-                        continue;
-                    }
+                    AdoptPointee(ptr, aPreviousData, reinterpret_cast<const uint8_t*>(pointee), aContext);
                 }
-                else
+            }
+        }
+    }
+
+    void MemoryProcessorImpl::AdoptPointee(const Layout::Ptr& aPtr, const uint8_t* aParent, const uint8_t* aPreviousPointee,
+                                           FrameReadContext& aContext)
+    {
+        if (!aPtr.m_walk)
+        {
+            AdoptSubtree(GetPointeeLayout(aPtr, aParent), aPreviousPointee, aContext);
+            return;
+        }
+        if (!aContext.Adopt(aPreviousPointee))
+        {
+            return;
+        }
+        const auto* layout = GetPointeeLayout(aPtr, aParent);
+        for (const auto* node : GetWalkedNodes<uint8_t>(aPreviousPointee))
+        {
+            AdoptSubtree(layout, node, aContext);
+        }
+    }
+
+    // TODO refactor this + Layout logic
+    uint8_t* MemoryProcessorImpl::ResolvePointers(const Layout& aLayout, size_t aFromAddress, uint8_t* aStoragePtr,
+                                                  FrameReadContext& aContext)
+    {
+        std::vector<PendingPointee> pending;
+        size_t scatteredOffset = 0;
+        for (const auto& ptr : aLayout.GetPointerOffsets())
+        {
+            auto slotOffset = [&, scatteredBase = scatteredOffset](size_t i) {
+                return (aLayout.IsConsecutive() ? ptr.m_mlp.front() : scatteredBase) + i * sizeof(size_t);
+            };
+            auto locatePointer = [&](size_t i) -> std::pair<size_t*, size_t> {
+                auto* castedPtr = reinterpret_cast<size_t*>(aStoragePtr + slotOffset(i));
+                if (aLayout.IsConsecutive() && *castedPtr == 0)
                 {
-                    castedPtr = reinterpret_cast<size_t*>(storagePtr + localOffset);
-                    localOffset += sizeof(size_t);
+                    return {nullptr, 0};
                 }
                 // TODO here I read again already read address, but it should work for now
                 auto finalAddress = m_memoryAccess->Dereference(aFromAddress + i * sizeof(size_t), ptr.m_mlp);
-                if (layout->IsConsecutive())
+                if (aLayout.IsConsecutive())
                 {
                     m_memoryAccess->Read(finalAddress, PMA::mem_cast(finalAddress), sizeof(finalAddress));
                 }
-                if (!aPointerMap.contains(finalAddress))
+                return {castedPtr, finalAddress};
+            };
+            auto locatePointers = [&]() {
+                std::vector<std::pair<size_t*, size_t>> located;
+                auto* batchReader = aContext.GetBatchReader();
+                if (!batchReader)
+                {
+                    for (size_t i = 0; i < ptr.m_count; ++i)
+                    {
+                        if (auto pointer = locatePointer(i); pointer.first)
+                        {
+                            located.push_back(pointer);
+                        }
+                    }
+                    return located;
+                }
+                // Chains of all pointers advance together, one round trip per level instead of one per pointer and level
+                for (size_t i = 0; i < ptr.m_count; ++i)
+                {
+                    auto* castedPtr = reinterpret_cast<size_t*>(aStoragePtr + slotOffset(i));
+                    if (!aLayout.IsConsecutive() || *castedPtr != 0)
+                    {
+                        located.emplace_back(castedPtr, aFromAddress + i * sizeof(size_t) + ptr.m_mlp.front());
+                    }
+                }
+                std::vector<size_t> bytesRead(located.size());
+                auto levels = ptr.m_mlp.size() - (aLayout.IsConsecutive() ? 0 : 1);
+                for (size_t level = 1; level <= levels; ++level)
                 {
-                    if (std::holds_alternative<Layout::LayoutIdProvider>(ptr.m_pointeeType))
+                    for (size_t i = 0; i < located.size(); ++i)
+                    {
+                        batchReader->Queue(located[i].second, &located[i].second, sizeof(size_t), &bytesRead[i]);
+                    }
+                    batchReader->Flush();
+                    for (size_t i = 0; i < located.size(); ++i)
+                    {
+                        if (bytesRead[i] != sizeof(size_t))
+                        {
+                            located[i].second = 0;
+                        }
+                        else if (level < ptr.m_mlp.size())
+                        {
+                            located[i].second += ptr.m_mlp[level];
+                        }
+                    }
+                }
+                // Broken chains leave the pointer empty, it must not keep an address of the target process
+                std::erase_if(located, [](const auto& aPointer) {
+                    if (aPointer.second == 0)
                     {
-                        auto& layoutIdProvider = std::get<Layout::LayoutIdProvider>(ptr.m_pointeeType);
-                        aPointerMap[finalAddress] = ReadLayout(layoutIdProvider(storagePtr), finalAddress, aPointerMap,
-                                                               aCurrentFrameStorage);
+                        *aPointer.first = 0;
+                        return true;
                     }
-                    else
+                    return false;
+                });
+                return located;
+            };
+            auto resolvePointer = [&](size_t i) {
+                if (auto [castedPtr, finalAddress] = locatePointer(i); castedPtr)
+                {
+                    *castedPtr = reinterpret_cast<size_t>(ReadPointee(ptr, finalAddress, aStoragePtr, aContext));
+                }
+            };
+            if (!aLayout.IsConsecutive())
+            {
+                scatteredOffset += ptr.m_count * sizeof(size_t);
+            }
+
+            if (aContext.Exceeded(ptr.m_priority))
+            {
+                // Out of budget, take the pointees the previous frame stored for this object
+                if (const auto* previous = aContext.GetPreviousFrame()->FindData(aFromAddress, aLayout.GetTotalSize()))
+                {
+                    for (size_t i = 0; i < ptr.m_count; ++i)
                     {
-                        auto& dataSizeProvider = std::get<Layout::DataSizeProvider>(ptr.m_pointeeType);
-                        aPointerMap[finalAddress] = ReadData(dataSizeProvider(storagePtr), finalAddress, aCurrentFrameStorage);
+                        auto pointee = *reinterpret_cast<const size_t*>(previous + slotOffset(i));
+                        if (pointee)
+                        {
+                            AdoptPointee(ptr, previous, reinterpret_cast<const uint8_t*>(pointee), aContext);
+                        }
+                        *reinterpret_cast<size_t*>(aStoragePtr + slotOffset(i)) = pointee;
                     }
+                    continue;
                 }
-                *castedPtr = reinterpret_cast<size_t>(aPointerMap[finalAddress]);
             }
+
+            if (ptr.m_walk)
+            {
+                // Walks overlap the reads of their chains on their own
+                for (auto [castedPtr, finalAddress] : locatePointers())
+                {
+                    *castedPtr = reinterpret_cast<size_t>(ReadWalk(ptr, finalAddress, aStoragePtr, aContext));
+                }
+                continue;
+            }
+
+            // Append-only data is read directly, its reads depend on the previous frame
+            if (aContext.GetBatchReader() && !ptr.m_appendOnly)
+            {
+                // Pointee reads of the whole layout are queued and overlap, they are finished after the loop
+                for (auto [castedPtr, finalAddress] : locatePointers())
+                {
+                    QueuePointee(ptr, finalAddress, aStoragePtr, castedPtr, aContext, pending);
+                }
+                continue;
+            }
+
+            auto* pool = aContext.GetPool();
+            if (!pool || ptr.m_count < m_parallelThreshold)
+            {
+                for (size_t i = 0; i < ptr.m_count; ++i)
+                {
+                    resolvePointer(i);
+                }
+                continue;
+            }
+            // Wide subtree, split it into chunks which idle workers can steal
+            const size_t chunk = std::max<size_t>(1, ptr.m_count / (4 * (pool->GetWorkerCount() + 1)));
+            TaskGroup group(*pool);
+            for (size_t begin = 0; begin < ptr.m_count; begin += chunk)
+            {
+                group.Run([&resolvePointer, begin, end = std::min(begin + chunk, ptr.m_count)]() {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        resolvePointer(i);
+                    }
+                });
+            }
+            group.Wait();
         }
-        return storagePtr;
+        if (!pending.empty())
+        {
+            FinishPointees(pending, aContext);
+        }
+        // Pointers are already translated to local storage, so unchanged subtrees make the parent identical as well
+        return aContext.GetStorage().ShareUnchanged(aStoragePtr, aContext.GetPreviousFrame());
     }
 
     MemoryProcessorImpl::MemoryProcessorImpl(std::shared_ptr<spdlog::logger> aLogger)
-        : m_storedFrames(std::make_shared<std::deque<FrameMemoryStorage>>())
+        : m_storedFrames(std::make_shared<FrameHistory>())
+        , m_blockPool(std::make_shared<BlockPool>())
         , m_logger(std::move(aLogger))
+        , m_frameLog(std::make_unique<AsyncLog>(m_logger))
+        , m_clock(Clock::GetSteady())
     {
         m_logger->info("MemoryProcessor created");
     }
@@ -228,6 +908,100 @@ namespace GE
         m_refreshRateMs = aRateMs.value_or(1000 / aFramesToKeep);
     }
 
+    void MemoryProcessorImpl::AddUpdateConsumer(UpdateConsumer aConsumer)
+    {
+        EnsureNotRunning();
+        if (!aConsumer.m_callback || aConsumer.m_framesRequired == 0)
+        {
+            throw std::runtime_error("UpdateConsumer requires a callback and at least one frame");
+        }
+        m_logger->info("Adding update consumer: every {} ms, {} frames", aConsumer.m_period.count(), aConsumer.m_framesRequired);
+        auto& state = m_consumers.emplace_back(std::make_unique<ConsumerState>());
+        state->m_consumer = std::move(aConsumer);
+    }
+
+    void MemoryProcessorImpl::SetHistoryTiers(std::vector<HistoryTier> aTiers)
+    {
+        EnsureNotRunning();
+        for (const auto& tier : aTiers)
+        {
+            if (tier.m_stride == 0)
+            {
+                throw std::runtime_error("HistoryTier stride cannot be 0");
+            }
+            m_logger->info("History tier: every {}. frame for {} ms", tier.m_stride, tier.m_span.count());
+        }
+        m_historyTiers = std::move(aTiers);
+    }
+
+    void MemoryProcessorImpl::SetFrameDeduplication(bool aEnabled, std::optional<TickProbe> aProbe)
+    {
+        EnsureNotRunning();
+        if (aProbe && (!aProbe->m_locator || aProbe->m_size == 0))
+        {
+            throw std::runtime_error("TickProbe requires a locator and a non-zero size");
+        }
+        m_logger->info("Frame deduplication {}{}", aEnabled ? "enabled" : "disabled", aProbe ? " with tick probe" : "");
+        m_deduplicate = aEnabled;
+        m_tickProbe = std::move(aProbe);
+    }
+
+    void MemoryProcessorImpl::SetMemoryBudget(std::optional<size_t> aBytes)
+    {
+        EnsureNotRunning();
+        if (aBytes)
+        {
+            m_logger->info("Memory budget: {} bytes", *aBytes);
+        }
+        m_memoryBudget = aBytes;
+    }
+
+    MemoryUsage MemoryProcessorImpl::GetMemoryUsage() const
+    {
+        std::scoped_lock lock(m_usageMutex);
+        return m_memoryUsage;
+    }
+
+    void MemoryProcessorImpl::SetFrameBudget(std::optional<std::chrono::microseconds> aBudget)
+    {
+        EnsureNotRunning();
+        if (aBudget)
+        {
+            m_logger->info("Frame budget: {} us", aBudget->count());
+        }
+        m_frameBudget = aBudget;
+    }
+
+    void MemoryProcessorImpl::SetParallelRead(size_t aWorkers, size_t aSubtreeThreshold)
+    {
+        EnsureNotRunning();
+        m_logger->info("Parallel read: {} workers, subtree threshold {}", aWorkers, aSubtreeThreshold);
+        m_walkerPool = aWorkers > 0 ? std::make_unique<WorkStealingPool>(aWorkers) : nullptr;
+        m_parallelThreshold = aSubtreeThreshold;
+    }
+
+    void MemoryProcessorImpl::SetBatchReader(BatchReaderPtr aBatchReader)
+    {
+        EnsureNotRunning();
+        m_logger->info("Batched reads {}", aBatchReader ? "enabled" : "disabled");
+        m_batchReader = std::move(aBatchReader);
+    }
+
+    void MemoryProcessorImpl::SetClock(ClockPtr aClock)
+    {
+        EnsureNotRunning();
+        if (!aClock)
+        {
+            throw std::runtime_error("Clock cannot be null");
+        }
+        m_clock = std::move(aClock);
+    }
+
+    ClockPtr MemoryProcessorImpl::GetClock() const
+    {
+        return m_clock;
+    }
+
     void MemoryProcessorImpl::RegisterLayout(const LayoutId& aLayoutId, std::unique_ptr<Layout> aLayout)
     {
         EnsureNotRunning();
@@ -247,6 +1021,21 @@ namespace GE
     {
         m_dataAccessor.reset();
         m_storedFrames->clear();
+        m_frameSequence = 0;
+        m_lastTick.clear();
+        m_appendTracker.Clear();
+        m_lowestReportedDepth = SIZE_MAX;
+        {
+            std::scoped_lock lock(m_usageMutex);
+            m_memoryUsage.m_bytes = 0;
+            m_memoryUsage.m_frames = 0;
+            m_memoryUsage.m_bytesByLayout.clear();
+        }
+        for (auto& state : m_consumers)
+        {
+            state->m_nextDue = {};
+            state->m_consecutiveFailures = 0;
+        }
     }
 
     void MemoryProcessorImpl::Start(PMA::MemoryAccessPtr aMemoryAccess)
@@ -262,58 +1051,80 @@ namespace GE
     void MemoryProcessorImpl::RequestStart(PMA::MemoryAccessPtr aMemoryAccess)
     {
         EnsureNotRunning();
-        if (!m_updateCallback)
+        if (!m_updateCallback && m_consumers.empty())
         {
             throw std::runtime_error("No update callback set!");
         }
         m_logger->info("Requesting start");
+        auto refreshRate = GetRefreshRate();
+        m_historyDepth = m_framesToKeep;
+        for (const auto& state : m_consumers)
+        {
+            m_historyDepth = std::max(m_historyDepth, state->m_consumer.m_framesRequired);
+            if (state->m_consumer.m_period < refreshRate)
+            {
+                m_logger->warn("Update consumer period {} ms is shorter than the refresh rate {} ms",
+                               state->m_consumer.m_period.count(), refreshRate.count());
+            }
+        }
+        // Worker per consumer, each consumer has at most one call in flight and never waits behind another one
+        if (!m_consumers.empty() && (!m_consumerPool || m_consumerPool->GetWorkerCount() != m_consumers.size()))
+        {
+            m_consumerPool = std::make_unique<WorkStealingPool>(m_consumers.size());
+        }
         m_memoryAccess = std::move(aMemoryAccess);
-        m_updateThread = std::jthread([this](std::stop_token aStopToken) {
+        m_updateThread = std::jthread([this, refreshRate](std::stop_token aStopToken) {
             try
             {
-                m_logger->info("Update thread started");
+                GE_LOG_INFO(m_frameLog, "Update thread started");
                 m_running = true;
                 m_onRunningChangedCallback(true);
                 m_dataAccessor = std::make_shared<DataAccessorImpl>(m_storedFrames);
                 while (!aStopToken.stop_requested())
                 {
-                    m_logger->trace("Next frame iteration");
-                    auto frameStartTime = std::chrono::steady_clock::now();
+                    GE_LOG_TRACE(m_frameLog, "Next frame iteration");
+                    auto frameStartTime = m_clock->Now();
                     try
                     {
-                        ReadMainLayouts();
-                        Update();
+                        TraceSpan frameSpan("Frame");
+                        if (TargetAdvanced() && ReadMainLayouts())
+                        {
+                            Update();
+                            DispatchConsumers();
+                        }
                     }
                     catch (const std::exception& e)
                     {
                         if (!m_memoryAccess->IsValid())
                         {
-                            m_logger->warn("Stopping MemoryProcessor: MemoryAccess is no longer valid - {}", e.what());
+                            GE_LOG_WARN(m_frameLog, "Stopping MemoryProcessor: MemoryAccess is no longer valid - {}", e.what());
                         }
                         else
                         {
-                            m_logger->error("Stopping MemoryProcessor: Unrecoverable error - {}", e.what());
+                            GE_LOG_ERROR(m_frameLog, "Stopping MemoryProcessor: Unrecoverable error - {}", e.what());
                         }
                         break;
                     }
-                    std::this_thread::sleep_until(frameStartTime + std::chrono::milliseconds(m_refreshRateMs));
+                    m_clock->SleepUntil(frameStartTime + refreshRate);
                 }
+                WaitForConsumers();
                 ResetStoredData();
                 m_running = false;
                 m_memoryAccess.reset();
                 m_onRunningChangedCallback(false);
-                m_logger->info("Update thread stopped");
+                GE_LOG_INFO(m_frameLog, "Update thread stopped");
             }
             catch (const std::exception& e)
             {
-                m_logger->error("Unhandled exception in update thread: {}", e.what());
+                GE_LOG_ERROR(m_frameLog, "Unhandled exception in update thread: {}", e.what());
                 m_running = false;
                 m_onRunningChangedCallback(false);
+                WaitForConsumers();
                 ResetStoredData();
             }
             catch (...)
             {
-                m_logger->error("Super unexpected error in update thread");
+                GE_LOG_ERROR(m_frameLog, "Super unexpected error in update thread");
             }
         });
     }
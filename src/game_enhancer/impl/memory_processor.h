@@ -1,13 +1,22 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
+#include "game_enhancer/batch_reader.h"
+#include "game_enhancer/impl/layout/append_tracker.h"
 #include "game_enhancer/impl/layout/frame_memory_storage.h"
+#include "game_enhancer/impl/layout/frame_read_context.h"
+#include "game_enhancer/impl/utils/async_log.h"
+#include "game_enhancer/impl/utils/work_stealing_pool.h"
 #include "game_enhancer/memory_processor.h"
 #include "pma/impl/callback/callback.h"
 #include "pma/memory_access.h"
@@ -23,6 +32,25 @@ namespace GE
         std::optional<PMA::MemoryAddress> m_dataFromEnabler;
     };
 
+    struct ConsumerState
+    {
+        UpdateConsumer m_consumer;
+        Clock::TimePoint m_nextDue;
+        // Set while dispatched, a consumer has at most one call in flight
+        std::atomic<bool> m_busy = false;
+        size_t m_consecutiveFailures = 0;
+    };
+
+    /*
+     * Node found by a walk. m_chain is the index of the root it was reached from, m_node the stored node once read.
+     */
+    struct WalkItem
+    {
+        size_t m_address = 0;
+        size_t m_chain = 0;
+        size_t m_node = 0;
+    };
+
     class MemoryProcessorImpl : public MemoryProcessor
     {
         class EnablerImpl : public Enabler
@@ -48,25 +76,71 @@ namespace GE
 
         PMA::Callback<bool> m_onRunningChangedCallback;
 
-        std::shared_ptr<std::deque<FrameMemoryStorage>> m_storedFrames;
+        std::shared_ptr<FrameHistory> m_storedFrames;
+        std::shared_ptr<BlockPool> m_blockPool;
         size_t m_framesToKeep = 2;
+        // m_framesToKeep or more when an update consumer requires deeper history
+        size_t m_historyDepth = 2;
+        std::vector<HistoryTier> m_historyTiers;
+        size_t m_frameSequence = 0;
+
+        bool m_deduplicate = false;
+        std::optional<TickProbe> m_tickProbe;
+        std::optional<std::chrono::microseconds> m_frameBudget;
+        std::optional<size_t> m_memoryBudget;
+        // Lowest history depth reported while over the memory budget, avoids logging every frame
+        size_t m_lowestReportedDepth = SIZE_MAX;
+        mutable std::mutex m_usageMutex;
+        MemoryUsage m_memoryUsage;
+        std::vector<uint8_t> m_lastTick;
+        std::vector<uint8_t> m_currentTick;
+        AppendTracker m_appendTracker;
+
+        BatchReaderPtr m_batchReader;
+        std::unique_ptr<WorkStealingPool> m_walkerPool;
+        size_t m_parallelThreshold = 64;
 
         size_t m_refreshRateMs = 100;
         std::jthread m_updateThread;
         std::function<void(const DataAccessor&)> m_updateCallback;
         size_t m_consecutiveFailedUpdates = 0;
+        std::vector<std::unique_ptr<ConsumerState>> m_consumers;
+        std::unique_ptr<WorkStealingPool> m_consumerPool;
         std::atomic<bool> m_running = false;
 
         std::shared_ptr<DataAccessor> m_dataAccessor;
 
         std::shared_ptr<spdlog::logger> m_logger;
+        // Used from the update thread, which must not wait for sinks
+        std::unique_ptr<AsyncLog> m_frameLog;
+
+        ClockPtr m_clock;
 
-        void ReadMainLayouts();
+        bool TargetAdvanced();
+        bool ReadMainLayouts();
+        void EnforceMemoryBudget();
         void Update();
+        void DispatchConsumers();
+        void RunConsumer(ConsumerState& aState, const std::shared_ptr<const FrameHistory>& aFrames);
+        void WaitForConsumers();
+        std::chrono::milliseconds GetRefreshRate() const;
         uint8_t* Allocate(size_t aBytes, size_t aFromAddress, FrameMemoryStorage& aCurrentFrameStorage);
-        uint8_t* ReadData(size_t aBytes, size_t aFromAddress, FrameMemoryStorage& aCurrentFrameStorage);
-        uint8_t* ReadLayout(const LayoutId& aLayoutId, size_t aFromAddress, std::unordered_map<size_t, uint8_t*>& aPointerMap,
-                            FrameMemoryStorage& aCurrentFrameStorage);
+        uint8_t* ReadData(size_t aBytes, size_t aFromAddress, FrameMemoryStorage& aCurrentFrameStorage,
+                          BatchReader* aBatchReader = nullptr);
+        uint8_t* ReadAppendOnlyData(size_t aBytes, size_t aFromAddress, FrameReadContext& aContext);
+        uint8_t* ReadPointee(const Layout::Ptr& aPtr, size_t aFromAddress, uint8_t* aParent, FrameReadContext& aContext);
+        void QueuePointee(const Layout::Ptr& aPtr, size_t aFromAddress, uint8_t* aParent, size_t* aSlot,
+                          FrameReadContext& aContext, std::vector<PendingPointee>& aPending);
+        uint8_t* FinishPointee(PendingPointee& aPointee, FrameReadContext& aContext);
+        void FinishPointees(std::vector<PendingPointee>& aPending, FrameReadContext& aContext);
+        uint8_t* ReadWalk(const Layout::Ptr& aPtr, size_t aFromAddress, uint8_t* aParent, FrameReadContext& aContext);
+        void ReadWalkLevel(const Layout::Ptr& aPtr, std::vector<WalkItem>& aLevel, uint8_t* aParent, FrameReadContext& aContext);
+        uint8_t* ReadLayout(const LayoutId& aLayoutId, size_t aFromAddress, FrameReadContext& aContext);
+        const Layout* GetPointeeLayout(const Layout::Ptr& aPtr, const uint8_t* aParent);
+        void AdoptSubtree(const Layout* aLayout, const uint8_t* aPreviousData, FrameReadContext& aContext);
+        void AdoptPointee(const Layout::Ptr& aPtr, const uint8_t* aParent, const uint8_t* aPreviousPointee,
+                          FrameReadContext& aContext);
+        uint8_t* ResolvePointers(const Layout& aLayout, size_t aFromAddress, uint8_t* aStoragePtr, FrameReadContext& aContext);
         void EnsureNotRunning() const;
 
         void ResetStoredData();
@@ -79,6 +153,16 @@ namespace GE
         void AddMainLayout(const LayoutId& aLayoutId, const MainLayoutCallbacks& aCallbacks) override;
         void SetUpdateCallback(const std::function<void(const DataAccessor&)>& aCallback, size_t aFramesToKeep = 2,
                                std::optional<size_t> aRateMs = {}) override;
+        void AddUpdateConsumer(UpdateConsumer aConsumer) override;
+        void SetHistoryTiers(std::vector<HistoryTier> aTiers) override;
+        void SetFrameDeduplication(bool aEnabled, std::optional<TickProbe> aProbe = {}) override;
+        void SetMemoryBudget(std::optional<size_t> aBytes) override;
+        MemoryUsage GetMemoryUsage() const override;
+        void SetFrameBudget(std::optional<std::chrono::microseconds> aBudget) override;
+        void SetParallelRead(size_t aWorkers, size_t aSubtreeThreshold = 64) override;
+        void SetBatchReader(BatchReaderPtr aBatchReader) override;
+        void SetClock(ClockPtr aClock) override;
+        ClockPtr GetClock() const override;
         void Start(PMA::MemoryAccessPtr aMemoryAccess) override;
         void RequestStart(PMA::MemoryAccessPtr aMemoryAccess) override;
         void Stop() override;
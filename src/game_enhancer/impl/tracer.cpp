@@ -0,0 +1,236 @@
+#pragma once
+
+#include "game_enhancer/tracer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace GE
+{
+    namespace
+    {
+        constexpr size_t kDetailWords = (Tracer::kMaxDetailLength + 1) / sizeof(uint64_t);
+        static_assert(kDetailWords * sizeof(uint64_t) == Tracer::kMaxDetailLength + 1);
+
+        struct TraceEvent
+        {
+            const char* m_name = nullptr;
+            uint64_t m_beginNs = 0;
+            uint64_t m_endNs = 0;
+            std::array<char, Tracer::kMaxDetailLength + 1> m_detail{};
+        };
+
+        /*
+         * Slot of the ring guarded by a sequence lock. m_sequence is odd while the owner writes event n into the slot and
+         * 2 * n + 2 once it is written. Fields are atomics, so a reader racing with the owner copies garbage at worst and
+         * the sequence tells it to discard the copy.
+         */
+        struct TraceSlot
+        {
+            std::atomic<uint64_t> m_sequence = 0;
+            std::atomic<const char*> m_name = nullptr;
+            std::atomic<uint64_t> m_beginNs = 0;
+            std::atomic<uint64_t> m_endNs = 0;
+            std::array<std::atomic<uint64_t>, kDetailWords> m_detail{};
+
+            void Write(uint64_t aIndex, const TraceEvent& aEvent)
+            {
+                m_sequence.store(2 * aIndex + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                m_name.store(aEvent.m_name, std::memory_order_relaxed);
+                m_beginNs.store(aEvent.m_beginNs, std::memory_order_relaxed);
+                m_endNs.store(aEvent.m_endNs, std::memory_order_relaxed);
+                for (size_t i = 0; i < kDetailWords; ++i)
+                {
+                    uint64_t word = 0;
+                    std::memcpy(&word, aEvent.m_detail.data() + i * sizeof(word), sizeof(word));
+                    m_detail[i].store(word, std::memory_order_relaxed);
+                }
+                m_sequence.store(2 * aIndex + 2, std::memory_order_release);
+            }
+
+            /*
+             * Returns false when the slot does not hold event aIndex, or when it was overwritten while copying.
+             */
+            bool Read(uint64_t aIndex, TraceEvent& aEvent) const
+            {
+                auto sequence = m_sequence.load(std::memory_order_acquire);
+                if (sequence != 2 * aIndex + 2)
+                {
+                    return false;
+                }
+                aEvent.m_name = m_name.load(std::memory_order_relaxed);
+                aEvent.m_beginNs = m_beginNs.load(std::memory_order_relaxed);
+                aEvent.m_endNs = m_endNs.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < kDetailWords; ++i)
+                {
+                    auto word = m_detail[i].load(std::memory_order_relaxed);
+                    std::memcpy(aEvent.m_detail.data() + i * sizeof(word), &word, sizeof(word));
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return m_sequence.load(std::memory_order_relaxed) == sequence;
+            }
+        };
+
+        /*
+         * Single producer ring. The owner thread publishes m_head after writing an event.
+         */
+        struct ThreadBuffer
+        {
+            size_t m_threadId = 0;
+            std::atomic<uint64_t> m_head = 0;
+            std::atomic<uint64_t> m_tail = 0;
+            std::vector<TraceSlot> m_events = std::vector<TraceSlot>(Tracer::kEventsPerThread);
+        };
+
+        struct Registry
+        {
+            std::mutex m_mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+        };
+
+        Registry& GetRegistry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        /*
+         * Registers the buffer of its thread and releases it once the thread exits.
+         */
+        struct ThreadBufferOwner
+        {
+            std::shared_ptr<ThreadBuffer> m_buffer = std::make_shared<ThreadBuffer>();
+
+            ThreadBufferOwner()
+            {
+                m_buffer->m_threadId = std::hash<std::thread::id>{}(std::this_thread::get_id());
+                auto& registry = GetRegistry();
+                std::scoped_lock lock(registry.m_mutex);
+                registry.m_buffers.push_back(m_buffer);
+            }
+
+            ~ThreadBufferOwner()
+            {
+                auto& registry = GetRegistry();
+                std::scoped_lock lock(registry.m_mutex);
+                std::erase(registry.m_buffers, m_buffer);
+            }
+
+            ThreadBufferOwner(const ThreadBufferOwner&) = delete;
+            ThreadBufferOwner& operator=(const ThreadBufferOwner&) = delete;
+        };
+
+        ThreadBuffer& GetThreadBuffer()
+        {
+            thread_local ThreadBufferOwner owner;
+            return *owner.m_buffer;
+        }
+
+        void WriteEscaped(std::ostream& aOut, std::string_view aText)
+        {
+            for (char c : aText)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    aOut << '\\' << c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    aOut << std::format("\\u{:04x}", static_cast<int>(c));
+                }
+                else
+                {
+                    aOut << c;
+                }
+            }
+        }
+    }
+
+    uint64_t Tracer::Now()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void Tracer::Record(const char* aName, std::string_view aDetail, uint64_t aBeginNs, uint64_t aEndNs)
+    {
+        auto& buffer = GetThreadBuffer();
+        auto head = buffer.m_head.load(std::memory_order_relaxed);
+        TraceEvent event{aName, aBeginNs, aEndNs};
+        auto length = std::min(aDetail.size(), kMaxDetailLength);
+        std::copy_n(aDetail.data(), length, event.m_detail.data());
+        buffer.m_events[head % kEventsPerThread].Write(head, event);
+        buffer.m_head.store(head + 1, std::memory_order_release);
+    }
+
+    void Tracer::WriteChromeTrace(std::ostream& aOut)
+    {
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        {
+            auto& registry = GetRegistry();
+            std::scoped_lock lock(registry.m_mutex);
+            buffers = registry.m_buffers;
+        }
+
+        aOut << "{\"traceEvents\":[";
+        bool first = true;
+        TraceEvent event;
+        for (const auto& buffer : buffers)
+        {
+            auto head = buffer->m_head.load(std::memory_order_acquire);
+            auto begin = std::max(buffer->m_tail.load(std::memory_order_relaxed),
+                                  head > kEventsPerThread ? head - kEventsPerThread : 0);
+            for (auto i = begin; i < head; ++i)
+            {
+                // Events overwritten by the owner in the meantime are skipped
+                if (!buffer->m_events[i % kEventsPerThread].Read(i, event))
+                {
+                    continue;
+                }
+                aOut << (first ? "" : ",") << "\n{\"name\":\"";
+                WriteEscaped(aOut, event.m_name);
+                aOut << std::format("\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}", buffer->m_threadId,
+                                    event.m_beginNs / 1000.0, (event.m_endNs - event.m_beginNs) / 1000.0);
+                if (event.m_detail[0])
+                {
+                    aOut << ",\"args\":{\"detail\":\"";
+                    WriteEscaped(aOut, event.m_detail.data());
+                    aOut << "\"}";
+                }
+                aOut << "}";
+                first = false;
+            }
+        }
+        aOut << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    void Tracer::DumpChromeTrace(const std::filesystem::path& aPath)
+    {
+        std::ofstream out(aPath);
+        if (!out)
+        {
+            throw std::runtime_error(std::format("Cannot open trace file '{}'", aPath.string()));
+        }
+        WriteChromeTrace(out);
+    }
+
+    void Tracer::Clear()
+    {
+        auto& registry = GetRegistry();
+        std::scoped_lock lock(registry.m_mutex);
+        for (auto& buffer : registry.m_buffers)
+        {
+            buffer->m_tail.store(buffer->m_head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+    }
+}
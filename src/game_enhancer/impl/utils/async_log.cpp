@@ -0,0 +1,91 @@
+#pragma once
+
+#include "game_enhancer/impl/utils/async_log.h"
+
+#include <bit>
+#include <chrono>
+
+namespace GE
+{
+    AsyncLog::AsyncLog(std::shared_ptr<spdlog::logger> aLogger, size_t aCapacity)
+        : m_logger(std::move(aLogger))
+        , m_entries(std::make_unique<Entry[]>(std::bit_ceil(aCapacity)))
+        , m_mask(std::bit_ceil(aCapacity) - 1)
+    {
+        for (size_t i = 0; i <= m_mask; ++i)
+        {
+            m_entries[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+        m_consumer = std::jthread([this](std::stop_token aStopToken) {
+            while (!aStopToken.stop_requested())
+            {
+                if (!Drain())
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+        });
+    }
+
+    AsyncLog::~AsyncLog()
+    {
+        m_consumer.request_stop();
+        m_consumer.join();
+        Drain();
+        if (auto dropped = GetDroppedCount())
+        {
+            m_logger->warn("{} log messages dropped, async log ring was full", dropped);
+        }
+    }
+
+    std::pair<AsyncLog::Entry*, size_t> AsyncLog::Claim()
+    {
+        // Bounded multi producer queue, every entry carries the position it is ready for
+        auto position = m_enqueue.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& entry = m_entries[position & m_mask];
+            auto sequence = entry.m_sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    return {&entry, position};
+                }
+            }
+            else if (difference < 0)
+            {
+                return {nullptr, 0};
+            }
+            else
+            {
+                position = m_enqueue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool AsyncLog::Drain()
+    {
+        bool drained = false;
+        while (true)
+        {
+            auto& entry = m_entries[m_dequeue & m_mask];
+            if (entry.m_sequence.load(std::memory_order_acquire) != m_dequeue + 1)
+            {
+                return drained;
+            }
+            try
+            {
+                m_logger->log(entry.m_level, "{}", entry.m_formatter(entry.m_format, entry.m_args.data()));
+            }
+            catch (const std::exception& e)
+            {
+                m_logger->error("Cannot format async log message '{}': {}", entry.m_format, e.what());
+            }
+            entry.m_sequence.store(m_dequeue + m_mask + 1, std::memory_order_release);
+            ++m_dequeue;
+            drained = true;
+        }
+    }
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+namespace GE
+{
+    /*
+     * Logger for threads that must not format strings or wait for sinks, e.g. the frame thread.
+     * Arguments are captured into a preallocated ring and formatted by a background thread, which passes the message to the
+     * wrapped spdlog logger. String arguments are copied and truncated to kStringSize characters, other arguments have to
+     * be trivially copyable. Trace and debug messages are dropped when the ring is full.
+     * Info and warn messages are never lost: when the ring is full or a string argument would be truncated, they are
+     * formatted and passed to the logger by the calling thread, possibly before older messages still in the ring. Errors
+     * always take this synchronous path.
+     */
+    class AsyncLog
+    {
+    public:
+        static constexpr size_t kArgsSize = 192;
+        static constexpr size_t kStringSize = 63;
+        // Levels up to kMaxLossyLevel may be dropped or truncated, levels up to kMaxQueuedLevel go through the ring
+        static constexpr auto kMaxLossyLevel = spdlog::level::debug;
+        static constexpr auto kMaxQueuedLevel = spdlog::level::warn;
+
+    private:
+        struct CapturedString
+        {
+            std::array<char, kStringSize> m_data;
+            uint8_t m_size;
+        };
+
+        struct Entry
+        {
+            std::atomic<size_t> m_sequence = 0;
+            spdlog::level::level_enum m_level = spdlog::level::off;
+            std::string_view m_format;
+            std::string (*m_formatter)(std::string_view aFormat, const std::byte* aArgs) = nullptr;
+            alignas(std::max_align_t) std::array<std::byte, kArgsSize> m_args;
+        };
+
+        std::shared_ptr<spdlog::logger> m_logger;
+        std::unique_ptr<Entry[]> m_entries;
+        size_t m_mask;
+        std::atomic<size_t> m_enqueue = 0;
+        size_t m_dequeue = 0;
+        std::atomic<size_t> m_dropped = 0;
+        std::jthread m_consumer;
+
+        template <typename T>
+        static auto Capture(T&& aArg)
+        {
+            using Decayed = std::decay_t<T>;
+            if constexpr (std::is_convertible_v<const Decayed&, std::string_view>)
+            {
+                std::string_view text = aArg;
+                CapturedString captured;
+                captured.m_size = static_cast<uint8_t>(std::min(text.size(), kStringSize));
+                std::copy_n(text.data(), captured.m_size, captured.m_data.data());
+                return captured;
+            }
+            else
+            {
+                static_assert(std::is_trivially_copyable_v<Decayed>, "AsyncLog arguments must be strings or trivially copyable");
+                return Decayed(std::forward<T>(aArg));
+            }
+        }
+
+        template <typename T>
+        static bool FitsUntruncated(const T& aArg)
+        {
+            if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            {
+                return std::string_view(aArg).size() <= kStringSize;
+            }
+            else
+            {
+                return true;
+            }
+        }
+
+        template <typename T>
+        static auto Release(const T& aCaptured)
+        {
+            if constexpr (std::is_same_v<T, CapturedString>)
+            {
+                return std::string_view(aCaptured.m_data.data(), aCaptured.m_size);
+            }
+            else
+            {
+                return aCaptured;
+            }
+        }
+
+        template <typename Captured>
+        static std::string Format(std::string_view aFormat, const std::byte* aArgs)
+        {
+            return std::apply(
+                [aFormat](const auto&... aCaptured) {
+                    auto released = std::make_tuple(Release(aCaptured)...);
+                    return std::apply(
+                        [aFormat](auto&... aValues) {
+                            return std::vformat(aFormat, std::make_format_args(aValues...));
+                        },
+                        released);
+                },
+                *reinterpret_cast<const Captured*>(aArgs));
+        }
+
+        std::pair<Entry*, size_t> Claim();
+
+        /*
+         * Formats and emits all committed messages, returns false when there were none.
+         */
+        bool Drain();
+
+    public:
+        AsyncLog(std::shared_ptr<spdlog::logger> aLogger, size_t aCapacity = 1024);
+        ~AsyncLog();
+
+        AsyncLog(const AsyncLog&) = delete;
+        AsyncLog& operator=(const AsyncLog&) = delete;
+
+        template <typename... Args>
+        void Log(spdlog::level::level_enum aLevel, std::format_string<Args...> aFormat, Args&&... aArgs)
+        {
+            if (!m_logger->should_log(aLevel))
+            {
+                return;
+            }
+            using Captured = std::tuple<decltype(Capture(std::declval<Args>()))...>;
+            static_assert(sizeof(Captured) <= kArgsSize, "AsyncLog arguments too large");
+            bool lossy = aLevel <= kMaxLossyLevel;
+            if (aLevel <= kMaxQueuedLevel && (lossy || (FitsUntruncated(aArgs) && ...)))
+            {
+                if (auto [entry, position] = Claim(); entry)
+                {
+                    entry->m_level = aLevel;
+                    entry->m_format = aFormat.get();
+                    entry->m_formatter = &Format<Captured>;
+                    new (entry->m_args.data()) Captured(Capture(std::forward<Args>(aArgs))...);
+                    entry->m_sequence.store(position + 1, std::memory_order_release);
+                    return;
+                }
+                if (lossy)
+                {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            m_logger->log(aLevel, "{}", std::vformat(aFormat.get(), std::make_format_args(aArgs...)));
+        }
+
+        template <typename... Args>
+        void trace(std::format_string<Args...> aFormat, Args&&... aArgs)
+        {
+            Log(spdlog::level::trace, aFormat, std::forward<Args>(aArgs)...);
+        }
+
+        template <typename... Args>
+        void debug(std::format_string<Args...> aFormat, Args&&... aArgs)
+        {
+            Log(spdlog::level::debug, aFormat, std::forward<Args>(aArgs)...);
+        }
+
+        template <typename... Args>
+        void info(std::format_string<Args...> aFormat, Args&&... aArgs)
+        {
+            Log(spdlog::level::info, aFormat, std::forward<Args>(aArgs)...);
+        }
+
+        template <typename... Args>
+        void warn(std::format_string<Args...> aFormat, Args&&... aArgs)
+        {
+            Log(spdlog::level::warn, aFormat, std::forward<Args>(aArgs)...);
+        }
+
+        template <typename... Args>
+        void error(std::format_string<Args...> aFormat, Args&&... aArgs)
+        {
+            Log(spdlog::level::err, aFormat, std::forward<Args>(aArgs)...);
+        }
+
+        size_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    };
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "game_enhancer/impl/utils/compare_kernels.h"
+
+#include <array>
+#include <cstring>
+
+#include "game_enhancer/impl/utils/cpu_features.h"
+
+namespace GE
+{
+    namespace
+    {
+        // Byte i of kSpread[mask] is bit i of mask
+        constexpr auto kSpread = []() {
+            std::array<uint64_t, 256> spread{};
+            for (uint64_t mask = 0; mask < 256; ++mask)
+            {
+                for (uint64_t bit = 0; bit < 8; ++bit)
+                {
+                    spread[mask] |= ((mask >> bit) & 1) << (bit * 8);
+                }
+            }
+            return spread;
+        }();
+
+        template <typename T>
+        void CompareScalar(const T* aValues, const T* aTargets, const uint8_t* aKinds, size_t aFrom, size_t aCount,
+                           uint8_t* aOut)
+        {
+            for (size_t i = aFrom; i < aCount; ++i)
+            {
+                auto relation = (aValues[i] < aTargets[i] ? kRelationLess : 0) |
+                                (aValues[i] == aTargets[i] ? kRelationEqual : 0) |
+                                (aValues[i] > aTargets[i] ? kRelationGreater : 0);
+                aOut[i] = (relation & aKinds[i]) != 0;
+            }
+        }
+
+#ifdef GE_X86
+        /*
+         * Lanes of aLess, aEqual and aGreater are all ones or zeros, aKinds holds one kind per 32-bit lane.
+         * Returns a bit per lane whose relation is in its kind.
+         */
+        int MatchSse2(__m128i aLess, __m128i aEqual, __m128i aGreater, __m128i aKinds)
+        {
+            auto relation = _mm_or_si128(_mm_or_si128(_mm_and_si128(aLess, _mm_set1_epi32(kRelationLess)),
+                                                      _mm_and_si128(aEqual, _mm_set1_epi32(kRelationEqual))),
+                                         _mm_and_si128(aGreater, _mm_set1_epi32(kRelationGreater)));
+            auto miss = _mm_cmpeq_epi32(_mm_and_si128(relation, aKinds), _mm_setzero_si128());
+            return ~_mm_movemask_ps(_mm_castsi128_ps(miss)) & 0xF;
+        }
+
+        __m128i LoadKindsSse2(const uint8_t* aKinds)
+        {
+            int32_t kinds;
+            std::memcpy(&kinds, aKinds, sizeof(kinds));
+            auto zero = _mm_setzero_si128();
+            return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(kinds), zero), zero);
+        }
+
+        void StoreMask(int aMask, size_t aLanes, uint8_t* aOut)
+        {
+            std::memcpy(aOut, &kSpread[aMask], aLanes);
+        }
+
+        size_t CompareSse2(const int32_t* aValues, const int32_t* aTargets, const uint8_t* aKinds, size_t aCount, uint8_t* aOut)
+        {
+            size_t i = 0;
+            for (; i + 4 <= aCount; i += 4)
+            {
+                auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aValues + i));
+                auto targets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aTargets + i));
+                auto mask = MatchSse2(_mm_cmplt_epi32(values, targets), _mm_cmpeq_epi32(values, targets),
+                                      _mm_cmpgt_epi32(values, targets), LoadKindsSse2(aKinds + i));
+                StoreMask(mask, 4, aOut + i);
+            }
+            return i;
+        }
+
+        size_t CompareSse2(const float* aValues, const float* aTargets, const uint8_t* aKinds, size_t aCount, uint8_t* aOut)
+        {
+            size_t i = 0;
+            for (; i + 4 <= aCount; i += 4)
+            {
+                auto values = _mm_loadu_ps(aValues + i);
+                auto targets = _mm_loadu_ps(aTargets + i);
+                auto mask = MatchSse2(_mm_castps_si128(_mm_cmplt_ps(values, targets)),
+                                      _mm_castps_si128(_mm_cmpeq_ps(values, targets)),
+                                      _mm_castps_si128(_mm_cmpgt_ps(values, targets)), LoadKindsSse2(aKinds + i));
+                StoreMask(mask, 4, aOut + i);
+            }
+            return i;
+        }
+
+        GE_TARGET_AVX2 int MatchAvx2(__m256i aLess, __m256i aEqual, __m256i aGreater, const uint8_t* aKinds)
+        {
+            auto kinds = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(aKinds)));
+            auto relation =
+                _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(aLess, _mm256_set1_epi32(kRelationLess)),
+                                                _mm256_and_si256(aEqual, _mm256_set1_epi32(kRelationEqual))),
+                                _mm256_and_si256(aGreater, _mm256_set1_epi32(kRelationGreater)));
+            auto miss = _mm256_cmpeq_epi32(_mm256_and_si256(relation, kinds), _mm256_setzero_si256());
+            return ~_mm256_movemask_ps(_mm256_castsi256_ps(miss)) & 0xFF;
+        }
+
+        GE_TARGET_AVX2 size_t CompareAvx2(const int32_t* aValues, const int32_t* aTargets, const uint8_t* aKinds, size_t aCount,
+                                          uint8_t* aOut)
+        {
+            size_t i = 0;
+            for (; i + 8 <= aCount; i += 8)
+            {
+                auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aValues + i));
+                auto targets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aTargets + i));
+                auto mask = MatchAvx2(_mm256_cmpgt_epi32(targets, values), _mm256_cmpeq_epi32(values, targets),
+                                      _mm256_cmpgt_epi32(values, targets), aKinds + i);
+                StoreMask(mask, 8, aOut + i);
+            }
+            return i;
+        }
+
+        GE_TARGET_AVX2 size_t CompareAvx2(const float* aValues, const float* aTargets, const uint8_t* aKinds, size_t aCount,
+                                          uint8_t* aOut)
+        {
+            size_t i = 0;
+            for (; i + 8 <= aCount; i += 8)
+            {
+                auto values = _mm256_loadu_ps(aValues + i);
+                auto targets = _mm256_loadu_ps(aTargets + i);
+                auto mask = MatchAvx2(_mm256_castps_si256(_mm256_cmp_ps(values, targets, _CMP_LT_OQ)),
+                                      _mm256_castps_si256(_mm256_cmp_ps(values, targets, _CMP_EQ_OQ)),
+                                      _mm256_castps_si256(_mm256_cmp_ps(values, targets, _CMP_GT_OQ)), aKinds + i);
+                StoreMask(mask, 8, aOut + i);
+            }
+            return i;
+        }
+#endif
+
+        template <typename T>
+        void Compare(const T* aValues, const T* aTargets, const uint8_t* aKinds, size_t aCount, uint8_t* aOut)
+        {
+            size_t done = 0;
+#ifdef GE_X86
+            static const bool avx2 = HasAvx2();
+            done = avx2 ? CompareAvx2(aValues, aTargets, aKinds, aCount, aOut)
+                        : CompareSse2(aValues, aTargets, aKinds, aCount, aOut);
+#endif
+            CompareScalar(aValues, aTargets, aKinds, done, aCount, aOut);
+        }
+    }
+
+    void CompareColumns(const int32_t* aValues, const int32_t* aTargets, const uint8_t* aKinds, size_t aCount, uint8_t* aOut)
+    {
+        Compare(aValues, aTargets, aKinds, aCount, aOut);
+    }
+
+    void CompareColumns(const float* aValues, const float* aTargets, const uint8_t* aKinds, size_t aCount, uint8_t* aOut)
+    {
+        Compare(aValues, aTargets, aKinds, aCount, aOut);
+    }
+}
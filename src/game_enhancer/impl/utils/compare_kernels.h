@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GE
+{
+    /*
+     * Relation bits of a compared value to its target, a kind is the set of relations counted as a match.
+     * NaN is in no relation, it never matches.
+     */
+    constexpr uint8_t kRelationLess = 1;
+    constexpr uint8_t kRelationEqual = 2;
+    constexpr uint8_t kRelationGreater = 4;
+
+    /*
+     * aOut[i] = 1 when the relation of aValues[i] to aTargets[i] is in aKinds[i], 0 otherwise.
+     * Uses AVX2 when the CPU supports it, SSE2 otherwise.
+     */
+    void CompareColumns(const int32_t* aValues, const int32_t* aTargets, const uint8_t* aKinds, size_t aCount, uint8_t* aOut);
+
+    void CompareColumns(const float* aValues, const float* aTargets, const uint8_t* aKinds, size_t aCount, uint8_t* aOut);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+/*
+ * x86 SIMD support shared by the vectorized kernels. GE_X86 is defined on x86-64, where SSE2 is always available.
+ * Functions using AVX2 are marked GE_TARGET_AVX2 and may run only when HasAvx2 returns true.
+ */
+#if defined(_M_X64) || defined(__x86_64__)
+#define GE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GE_TARGET_AVX2
+#else
+#define GE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace GE
+{
+    inline bool HasAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuidex(info, 1, 0);
+        bool osSupport = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        return osSupport && (info[1] & (1 << 5));
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+}
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "game_enhancer/impl/utils/frame_diff.h"
+
+#include <bit>
+
+#include "game_enhancer/impl/utils/cpu_features.h"
+
+namespace GE
+{
+    namespace
+    {
+        /*
+         * Appends runs of set bits in aMask, aMask bit i stands for byte aOffset + i.
+         * Only ranges from index aFirst on belong to the compared object and can be extended.
+         */
+        void AppendMask(uint32_t aMask, size_t aOffset, size_t aFirst, std::vector<ChangedRange>& aRanges)
+        {
+            while (aMask)
+            {
+                auto begin = static_cast<size_t>(std::countr_zero(aMask));
+                auto length = static_cast<size_t>(std::countr_one(aMask >> begin));
+                auto offset = aOffset + begin;
+                if (aRanges.size() > aFirst && aRanges.back().m_offset + aRanges.back().m_size == offset)
+                {
+                    aRanges.back().m_size += length;
+                }
+                else
+                {
+                    aRanges.push_back({offset, length});
+                }
+                aMask = length + begin >= 32 ? 0 : aMask & ~((1u << (begin + length)) - 1);
+            }
+        }
+
+        void DiffScalar(const uint8_t* aPrevious, const uint8_t* aCurrent, size_t aFrom, size_t aSize, size_t aFirst,
+                        std::vector<ChangedRange>& aRanges)
+        {
+            for (size_t i = aFrom; i < aSize; i += 32)
+            {
+                uint32_t mask = 0;
+                for (size_t j = 0; j < 32 && i + j < aSize; ++j)
+                {
+                    mask |= static_cast<uint32_t>(aPrevious[i + j] != aCurrent[i + j]) << j;
+                }
+                AppendMask(mask, i, aFirst, aRanges);
+            }
+        }
+
+#ifdef GE_X86
+        size_t DiffSse2(const uint8_t* aPrevious, const uint8_t* aCurrent, size_t aSize, size_t aFirst,
+                        std::vector<ChangedRange>& aRanges)
+        {
+            size_t i = 0;
+            for (; i + 16 <= aSize; i += 16)
+            {
+                auto previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aPrevious + i));
+                auto current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aCurrent + i));
+                auto equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(previous, current)));
+                if (equal != 0xFFFF)
+                {
+                    AppendMask(~equal & 0xFFFF, i, aFirst, aRanges);
+                }
+            }
+            return i;
+        }
+
+        GE_TARGET_AVX2 size_t DiffAvx2(const uint8_t* aPrevious, const uint8_t* aCurrent, size_t aSize, size_t aFirst,
+                                       std::vector<ChangedRange>& aRanges)
+        {
+            size_t i = 0;
+            for (; i + 32 <= aSize; i += 32)
+            {
+                auto previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aPrevious + i));
+                auto current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aCurrent + i));
+                auto equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(previous, current)));
+                if (equal != 0xFFFFFFFF)
+                {
+                    AppendMask(~equal, i, aFirst, aRanges);
+                }
+            }
+            return i;
+        }
+#endif
+    }
+
+    bool DiffBytes(const uint8_t* aPrevious, const uint8_t* aCurrent, size_t aSize, std::vector<ChangedRange>& aRanges)
+    {
+        auto rangesBefore = aRanges.size();
+        size_t done = 0;
+#ifdef GE_X86
+        static const bool avx2 = HasAvx2();
+        done = avx2 ? DiffAvx2(aPrevious, aCurrent, aSize, rangesBefore, aRanges)
+                    : DiffSse2(aPrevious, aCurrent, aSize, rangesBefore, aRanges);
+#endif
+        DiffScalar(aPrevious, aCurrent, done, aSize, rangesBefore, aRanges);
+        return aRanges.size() != rangesBefore;
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game_enhancer/data_accessor.h"
+
+namespace GE
+{
+    /*
+     * Appends byte ranges in which aCurrent differs from aPrevious to aRanges. Adjacent differences are merged into a single
+     * range, ranges already in aRanges are never extended. Returns true when anything differs.
+     * Uses AVX2 when the CPU supports it, SSE2 otherwise.
+     */
+    bool DiffBytes(const uint8_t* aPrevious, const uint8_t* aCurrent, size_t aSize, std::vector<ChangedRange>& aRanges);
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "game_enhancer/impl/utils/work_stealing_pool.h"
+
+namespace GE
+{
+    namespace
+    {
+        thread_local const WorkStealingPool* t_owner = nullptr;
+        thread_local size_t t_workerIndex = 0;
+    }
+
+    bool WorkStealingPool::TryPop(size_t aQueue, std::function<void()>& aTask, bool aFromBack)
+    {
+        auto& queue = *m_queues[aQueue];
+        std::scoped_lock lock(queue.m_mutex);
+        if (queue.m_tasks.empty())
+        {
+            return false;
+        }
+        if (aFromBack)
+        {
+            aTask = std::move(queue.m_tasks.back());
+            queue.m_tasks.pop_back();
+        }
+        else
+        {
+            aTask = std::move(queue.m_tasks.front());
+            queue.m_tasks.pop_front();
+        }
+        --m_queued;
+        return true;
+    }
+
+    void WorkStealingPool::WorkerLoop(std::stop_token aStopToken, size_t aIndex)
+    {
+        t_owner = this;
+        t_workerIndex = aIndex;
+        while (!aStopToken.stop_requested())
+        {
+            if (RunOne())
+            {
+                continue;
+            }
+            std::unique_lock lock(m_sleepMutex);
+            m_wakeUp.wait(lock, aStopToken, [this]() {
+                return m_queued > 0;
+            });
+        }
+    }
+
+    WorkStealingPool::WorkStealingPool(size_t aWorkers)
+    {
+        for (size_t i = 0; i <= aWorkers; ++i)
+        {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 1; i <= aWorkers; ++i)
+        {
+            m_threads.emplace_back([this, i](std::stop_token aStopToken) {
+                WorkerLoop(aStopToken, i);
+            });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        for (auto& thread : m_threads)
+        {
+            thread.request_stop();
+        }
+        m_wakeUp.notify_all();
+        m_threads.clear();
+    }
+
+    size_t WorkStealingPool::CurrentWorkerIndex() const
+    {
+        return t_owner == this ? t_workerIndex : 0;
+    }
+
+    void WorkStealingPool::Submit(std::function<void()> aTask)
+    {
+        auto index = CurrentWorkerIndex();
+        {
+            std::scoped_lock lock(m_queues[index]->m_mutex);
+            m_queues[index]->m_tasks.push_back(std::move(aTask));
+            ++m_queued;
+        }
+        std::scoped_lock lock(m_sleepMutex);
+        m_wakeUp.notify_one();
+    }
+
+    bool WorkStealingPool::RunOne()
+    {
+        std::function<void()> task;
+        auto own = CurrentWorkerIndex();
+        bool found = TryPop(own, task, true);
+        for (size_t i = 1; !found && i < m_queues.size(); ++i)
+        {
+            found = TryPop((own + i) % m_queues.size(), task, false);
+        }
+        if (!found)
+        {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    void WorkStealingPool::HelpUntil(const std::function<bool()>& aDone)
+    {
+        while (!aDone())
+        {
+            if (!RunOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool TaskGroup::State::RunOne()
+    {
+        std::function<void()> task;
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_tasks.empty())
+            {
+                return false;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::scoped_lock lock(m_mutex);
+            if (!m_error)
+            {
+                m_error = std::current_exception();
+            }
+        }
+        if (--m_pending == 0)
+        {
+            m_pending.notify_all();
+        }
+        return true;
+    }
+
+    TaskGroup::TaskGroup(WorkStealingPool& aPool)
+        : m_pool(aPool)
+        , m_state(std::make_shared<State>())
+    {
+    }
+
+    void TaskGroup::Run(std::function<void()> aTask)
+    {
+        ++m_state->m_pending;
+        {
+            std::scoped_lock lock(m_state->m_mutex);
+            m_state->m_tasks.push_back(std::move(aTask));
+        }
+        // The task may already be taken by the waiter when a worker gets to it, the handle then does nothing
+        m_pool.Submit([state = m_state]() {
+            state->RunOne();
+        });
+    }
+
+    void TaskGroup::Wait()
+    {
+        while (m_state->RunOne())
+        {
+        }
+        for (auto pending = m_state->m_pending.load(); pending != 0; pending = m_state->m_pending.load())
+        {
+            m_state->m_pending.wait(pending);
+        }
+        std::scoped_lock lock(m_state->m_mutex);
+        if (m_state->m_error)
+        {
+            std::rethrow_exception(m_state->m_error);
+        }
+    }
+}
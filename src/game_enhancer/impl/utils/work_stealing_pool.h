@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GE
+{
+    /*
+     * Every worker owns a deque of tasks. Workers push and pop at the back of their own deque and steal from the front of
+     * the others. Threads that are not part of the pool submit into the shared deque at index 0.
+     */
+    class WorkStealingPool
+    {
+        struct Queue
+        {
+            std::mutex m_mutex;
+            std::deque<std::function<void()>> m_tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::jthread> m_threads;
+        std::atomic<size_t> m_queued = 0;
+        std::mutex m_sleepMutex;
+        std::condition_variable_any m_wakeUp;
+
+        bool TryPop(size_t aQueue, std::function<void()>& aTask, bool aFromBack);
+        void WorkerLoop(std::stop_token aStopToken, size_t aIndex);
+
+    public:
+        WorkStealingPool(size_t aWorkers);
+        ~WorkStealingPool();
+
+        /*
+         * 0 for threads outside of this pool, 1..N for the pool workers.
+         */
+        size_t CurrentWorkerIndex() const;
+
+        size_t GetWorkerCount() const { return m_threads.size(); }
+
+        void Submit(std::function<void()> aTask);
+
+        /*
+         * Runs a single queued task on the calling thread. Returns false if there was nothing to run.
+         */
+        bool RunOne();
+
+        /*
+         * Helps with queued tasks until aDone returns true. Never blocks on an empty pool, so it is safe to call from workers.
+         */
+        void HelpUntil(const std::function<bool()>& aDone);
+    };
+
+    /*
+     * Tasks of a group are queued in the group and the pool only receives a handle to run the next one. Wait runs the
+     * remaining tasks of its own group and then sleeps, so it never nests unrelated work on the stack of the waiter.
+     */
+    class TaskGroup
+    {
+        struct State
+        {
+            std::mutex m_mutex;
+            std::deque<std::function<void()>> m_tasks;
+            std::atomic<size_t> m_pending = 0;
+            std::exception_ptr m_error;
+
+            bool RunOne();
+        };
+
+        WorkStealingPool& m_pool;
+        std::shared_ptr<State> m_state;
+
+    public:
+        TaskGroup(WorkStealingPool& aPool);
+
+        void Run(std::function<void()> aTask);
+
+        /*
+         * Runs queued tasks of this group and sleeps until the ones taken by workers finish.
+         * Rethrows the first exception thrown by any of the tasks.
+         */
+        void Wait();
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+ * Logging for hot paths. Statements below GE_ACTIVE_LOG_LEVEL are removed at compile time together with evaluation of
+ * their arguments. Works with any logger providing spdlog-like trace/debug/info/warn/error methods.
+ * GE_ACTIVE_LOG_LEVEL defaults to GE_LOG_LEVEL_INFO in release builds and GE_LOG_LEVEL_TRACE otherwise.
+ */
+#define GE_LOG_LEVEL_TRACE 0
+#define GE_LOG_LEVEL_DEBUG 1
+#define GE_LOG_LEVEL_INFO 2
+#define GE_LOG_LEVEL_WARN 3
+#define GE_LOG_LEVEL_ERROR 4
+#define GE_LOG_LEVEL_OFF 5
+
+#ifndef GE_ACTIVE_LOG_LEVEL
+#ifdef NDEBUG
+#define GE_ACTIVE_LOG_LEVEL GE_LOG_LEVEL_INFO
+#else
+#define GE_ACTIVE_LOG_LEVEL GE_LOG_LEVEL_TRACE
+#endif
+#endif
+
+#if GE_ACTIVE_LOG_LEVEL <= GE_LOG_LEVEL_TRACE
+#define GE_LOG_TRACE(aLogger, ...) (aLogger)->trace(__VA_ARGS__)
+#else
+#define GE_LOG_TRACE(aLogger, ...) (void)0
+#endif
+
+#if GE_ACTIVE_LOG_LEVEL <= GE_LOG_LEVEL_DEBUG
+#define GE_LOG_DEBUG(aLogger, ...) (aLogger)->debug(__VA_ARGS__)
+#else
+#define GE_LOG_DEBUG(aLogger, ...) (void)0
+#endif
+
+#if GE_ACTIVE_LOG_LEVEL <= GE_LOG_LEVEL_INFO
+#define GE_LOG_INFO(aLogger, ...) (aLogger)->info(__VA_ARGS__)
+#else
+#define GE_LOG_INFO(aLogger, ...) (void)0
+#endif
+
+#if GE_ACTIVE_LOG_LEVEL <= GE_LOG_LEVEL_WARN
+#define GE_LOG_WARN(aLogger, ...) (aLogger)->warn(__VA_ARGS__)
+#else
+#define GE_LOG_WARN(aLogger, ...) (void)0
+#endif
+
+#if GE_ACTIVE_LOG_LEVEL <= GE_LOG_LEVEL_ERROR
+#define GE_LOG_ERROR(aLogger, ...) (aLogger)->error(__VA_ARGS__)
+#else
+#define GE_LOG_ERROR(aLogger, ...) (void)0
+#endif
@@ -15,11 +15,41 @@ namespace GE
         using LayoutIdProvider = std::function<std::string(void*)>;
         using DataSizeProvider = std::function<size_t(void*)>;
 
+        /*
+         * When the frame budget runs out, subtrees of lower priority are not read and the previous frame data is reused.
+         * Low - Reused after 3/4 of the budget elapsed
+         * Normal - Reused after the whole budget elapsed
+         * High - Always read
+         */
+        enum class Priority
+        {
+            Low,
+            Normal,
+            High
+        };
+
+        /*
+         * Collects all nodes of a linked structure instead of only the first pointee, see Builder::AddListWalk.
+         * m_links - Offsets of pointers within a node leading to further nodes, e.g. next pointer or children of a tree
+         * m_maxItems - Nodes collected at most, also bounds cyclic structures
+         * m_buckets - When non zero, the pointer leads to an array of m_buckets chain heads instead of a single node
+         */
+        struct Walk
+        {
+            std::vector<size_t> m_links;
+            size_t m_maxItems = 0;
+            size_t m_buckets = 0;
+        };
+
         struct Ptr
         {
             PMA::MultiLevelPointer m_mlp;
             size_t m_count;
             std::variant<LayoutIdProvider, DataSizeProvider> m_pointeeType;
+            Priority m_priority = Priority::Normal;
+            std::optional<Walk> m_walk{};
+            // See Builder::SetAppendOnly
+            bool m_appendOnly = false;
         };
 
         virtual ~Layout() = default;
@@ -44,6 +74,42 @@ namespace GE
             virtual Builder& AddPointerOffsets(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp,
                                                const std::function<size_t(void*)>& aDynamicSize, size_t aCount = 1) = 0;
 
+            /*
+             * Pointer to the first node of a linked list, the pointer at aNextOffset of each node leads to the next one.
+             * Up to aMaxItems nodes of layout aNodeType are read and the pointer is stored as a dense array of them,
+             * iterate it with GetWalkedNodes. Layout aNodeType has to be consecutive and must not contain the next pointer.
+             */
+            virtual Builder& AddListWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp, const std::string& aNodeType,
+                                         size_t aNextOffset, size_t aMaxItems) = 0;
+
+            /*
+             * Pointer to an array of aBucketCount chain heads, e.g. a hash table with chained entries. Chains are read
+             * level by level, so the reads of all chains overlap. Nodes are stored chain after chain.
+             */
+            virtual Builder& AddBucketWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp,
+                                           const std::string& aNodeType, size_t aBucketCount, size_t aNextOffset,
+                                           size_t aMaxItems) = 0;
+
+            /*
+             * Pointer to the root of a tree, the pointers at aChildOffsets of each node lead to its children.
+             * Nodes are read and stored breadth first, up to aMaxItems of them.
+             */
+            virtual Builder& AddTreeWalk(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp, const std::string& aNodeType,
+                                         std::vector<size_t> aChildOffsets, size_t aMaxItems) = 0;
+
+            /*
+             * Sets priority of the most recently added pointer.
+             */
+            virtual Builder& SetPointerPriority(Priority aPriority) = 0;
+
+            /*
+             * Marks the most recently added pointer of dynamic size as leading to data only ever appended to, e.g. a log.
+             * Once the data grew unchanged for a few frames, only its new bytes and a guard before them are read, the
+             * rest is copied from the previous frame and fully read again every 64 frames. Edits before the guard are
+             * therefore missed until the next full read, data that is also edited in place must not be marked.
+             */
+            virtual Builder& SetAppendOnly() = 0;
+
             template <typename T>
             Builder& AddPointerOffsets(std::variant<size_t, PMA::MultiLevelPointer> aOffsetOrMlp,
                                        const std::function<std::string(T*)>& aDynamicType, size_t aCount = 1,
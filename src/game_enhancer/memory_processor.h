@@ -1,11 +1,15 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "game_enhancer/batch_reader.h"
+#include "game_enhancer/clock.h"
 #include "game_enhancer/data_accessor.h"
 #include "game_enhancer/memory_layout_builder.h"
 #include "pma/target_process.h"
@@ -30,6 +34,54 @@ namespace GE
         std::optional<std::function<void(const DataAccessor&, Enabler&)>> m_enabler;
         std::optional<std::function<void(const DataAccessor&)>> m_onDisabled;
         std::optional<std::function<void(std::shared_ptr<DataAccessor>)>> m_onReady;
+        Layout::Priority m_priority = Layout::Priority::Normal;
+    };
+
+    /*
+     * Every 'm_stride'-th frame is kept until it is older than 'm_span'.
+     * Strides of coarser tiers should be multiples of the finer ones, frames then move between tiers as they age.
+     */
+    struct HistoryTier
+    {
+        std::chrono::milliseconds m_span;
+        size_t m_stride = 1;
+    };
+
+    /*
+     * Small read done before every frame, e.g. a frame counter of the game.
+     * m_locator - Returns address of the probed value
+     * m_size - Number of bytes to compare
+     */
+    struct TickProbe
+    {
+        std::function<PMA::MemoryAddress(PMA::MemoryAccessPtr)> m_locator;
+        size_t m_size = sizeof(uint64_t);
+    };
+
+    /*
+     * Update callback with its own rate, run on a worker thread. See MemoryProcessor::AddUpdateConsumer.
+     * m_callback - Called with the frames stored at the time of dispatch, these stay valid until the callback returns
+     * m_period - Minimal time between two calls
+     * m_framesRequired - Number of newest frames the callback needs, it is not called before that many frames were stored
+     */
+    struct UpdateConsumer
+    {
+        std::function<void(const DataAccessor&)> m_callback;
+        std::chrono::milliseconds m_period{100};
+        size_t m_framesRequired = 1;
+    };
+
+    /*
+     * Bytes of object data held by the stored frames. Objects shared by consecutive frames are counted once.
+     * m_peakBytes - Highest m_bytes since the MemoryProcessor was created
+     * m_bytesByLayout - Bytes attributed to main layouts, including their whole subtrees
+     */
+    struct MemoryUsage
+    {
+        size_t m_bytes = 0;
+        size_t m_peakBytes = 0;
+        size_t m_frames = 0;
+        std::unordered_map<LayoutId, size_t> m_bytesByLayout;
     };
 
     /*
@@ -61,6 +113,7 @@ namespace GE
          *     - Check if enough frames stored
          *         - Yes: Once run the OnReadyCallback
          * - Run UpdateCallback
+         * - Dispatch due UpdateConsumers
          *
          * aLayoutId - Previously registered layout
          * aAnchorCallback - Should return address of where the layout starts
@@ -82,6 +135,76 @@ namespace GE
         virtual void SetUpdateCallback(const std::function<void(const DataAccessor&)>& aCallback, size_t aFramesToKeep = 2,
                                        std::optional<size_t> aRateMs = {}) = 0;
 
+        /*
+         * Adds a consumer which runs independently of the Update callback and of other consumers. Consumers are dispatched
+         * on worker threads after a frame was read, against a snapshot of the stored frames, so a slow consumer stalls neither
+         * the others nor the reading. A consumer still running when it is due again is skipped until it finishes.
+         * Consumers cannot run more often than frames are read. Without an Update callback frames are read at the rate of
+         * the fastest consumer. Frames are kept for the consumer with the deepest m_framesRequired.
+         */
+        virtual void AddUpdateConsumer(UpdateConsumer aConsumer) = 0;
+
+        /*
+         * Keeps older frames on top of the newest 'aFramesToKeep' frames set by SetUpdateCallback.
+         * e.g. {{1s, 1}, {60s, 10}, {600s, 100}} keeps every frame of the last second, every 10th frame of the last minute
+         * and every 100th frame of the last 10 minutes. Use DataAccessor::FindFrame to look frames up by time.
+         * Empty aTiers keeps only the newest 'aFramesToKeep' frames (default).
+         */
+        virtual void SetHistoryTiers(std::vector<HistoryTier> aTiers) = 0;
+
+        /*
+         * Skips frames in which the target did not advance, neither the frame is stored nor the Update callback called.
+         * With aProbe, the probe is read first every iteration and main layouts are read only when its value changed.
+         * Without aProbe, main layouts are read and the frame is dropped when it is identical to the previous one. Enablers are
+         * not called for dropped frames, while everything read so far is unchanged they are postponed until something changes.
+         * Keep disabled when the Update callback has to run periodically regardless of the data, e.g. for timers.
+         */
+        virtual void SetFrameDeduplication(bool aEnabled, std::optional<TickProbe> aProbe = {}) = 0;
+
+        /*
+         * Limits memory held by the stored frames. When a new frame exceeds aBytes, the oldest frames are evicted, ignoring
+         * history tiers, but never below the frames required by the Update callback and the update consumers.
+         * The main layouts retaining the most memory are logged. nullopt disables the budget (default).
+         */
+        virtual void SetMemoryBudget(std::optional<size_t> aBytes) = 0;
+
+        /*
+         * Can be called from any thread, the usage is updated after every stored frame.
+         */
+        virtual MemoryUsage GetMemoryUsage() const = 0;
+
+        /*
+         * Limits time spent reading a single frame. Once the budget runs out, main layouts and pointers of lower priority
+         * (see Layout::Priority) are not read anymore and their data from the previous frame is reused.
+         * Use DataAccessor::IsStale to check whether an object was reused. nullopt disables the budget (default).
+         */
+        virtual void SetFrameBudget(std::optional<std::chrono::microseconds> aBudget) = 0;
+
+        /*
+         * Opt-in parallel reading of wide subtrees. Pointers with 'aSubtreeThreshold' or more entries are split into tasks
+         * that are processed by 'aWorkers' threads. Every object is still stored only once per frame.
+         * MemoryAccess and dynamic type/size providers must be safe to call from multiple threads. Providers should only
+         * inspect non-pointer fields of the parent, as pointer fields might be translated concurrently.
+         * aWorkers - Number of additional threads. 0 disables parallel reading (default).
+         */
+        virtual void SetParallelRead(size_t aWorkers, size_t aSubtreeThreshold = 64) = 0;
+
+        /*
+         * Reads data of layouts through aBatchReader instead of the MemoryAccess. Pointees of a layout are queued together and
+         * their reads overlap, so do the reads of their pointer chains. MemoryAccess is still used by base locators and the
+         * tick probe.
+         * Ignored while parallel read is enabled. Pass nullptr to disable.
+         */
+        virtual void SetBatchReader(BatchReaderPtr aBatchReader) = 0;
+
+        /*
+         * Replaces the time source of the main loop, see Clock. Frame timestamps, update consumer periods, the frame budget
+         * and the refresh rate are measured on aClock. Pass a VirtualClock to process sessions faster than real time.
+         * Default: Clock::GetSteady()
+         */
+        virtual void SetClock(ClockPtr aClock) = 0;
+        virtual ClockPtr GetClock() const = 0;
+
         /*
          * OnReady callback is called after MemoryProcessor successfully started main loop and first 'FramesToKeep' frames were
          * read. In this callback, setup the SharedState and any helper classes that require DataAccessor to be fully initialized.
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string_view>
+
+namespace GE
+{
+    /*
+     * Process wide span recorder for analyzing frame pipeline stalls.
+     * Every thread records into its own ring buffer without locking, the oldest spans get overwritten. A buffer is
+     * released when its thread exits, the last spans before a failure can be dumped as long as the thread lives (flight
+     * recorder).
+     * Disabled by default, a disabled span costs a single relaxed atomic load.
+     */
+    class Tracer
+    {
+        static inline std::atomic<bool> s_enabled = false;
+
+    public:
+        static constexpr size_t kEventsPerThread = 16384;
+        static constexpr size_t kMaxDetailLength = 39;
+
+        static void SetEnabled(bool aEnabled) { s_enabled.store(aEnabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+        /*
+         * Nanoseconds of steady clock.
+         */
+        static uint64_t Now();
+
+        /*
+         * aName has to be a string literal, aDetail is copied and truncated to kMaxDetailLength characters.
+         */
+        static void Record(const char* aName, std::string_view aDetail, uint64_t aBeginNs, uint64_t aEndNs);
+
+        /*
+         * Writes all recorded spans in Chrome trace event format, loadable by chrome://tracing or Perfetto UI.
+         * Can be called while other threads keep recording.
+         */
+        static void WriteChromeTrace(std::ostream& aOut);
+        static void DumpChromeTrace(const std::filesystem::path& aPath);
+
+        /*
+         * Drops all recorded spans.
+         */
+        static void Clear();
+    };
+
+    class TraceSpan
+    {
+        const char* m_name;
+        std::string_view m_detail;
+        uint64_t m_begin = 0;
+
+    public:
+        explicit TraceSpan(const char* aName, std::string_view aDetail = {})
+            : m_name(aName)
+            , m_detail(aDetail)
+        {
+            if (Tracer::IsEnabled())
+            {
+                m_begin = Tracer::Now();
+            }
+        }
+
+        ~TraceSpan()
+        {
+            if (m_begin)
+            {
+                Tracer::Record(m_name, m_detail, m_begin, Tracer::Now());
+            }
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+    };
+}
@@ -0,0 +1,241 @@
+#include "synthetic_target_fixture.h"
+
+#ifdef __linux__
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "synthetic_target.h"
+
+extern char** environ;
+
+SyntheticTargetFixture::ProcMemAccess::ProcMemAccess(int aPid)
+    : m_pid(aPid)
+{
+    auto path = std::format("/proc/{}/mem", aPid);
+    m_memFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_memFd < 0)
+    {
+        throw std::runtime_error(std::format("Cannot open '{}': {}", path, std::strerror(errno)));
+    }
+}
+
+SyntheticTargetFixture::ProcMemAccess::~ProcMemAccess()
+{
+    close(m_memFd);
+}
+
+size_t SyntheticTargetFixture::ProcMemAccess::Read(PMA::MemoryAddress aAddress, void* aBuffer, size_t aBytes)
+{
+    ++m_reads;
+    m_bytes += aBytes;
+    if (m_clock)
+    {
+        m_clock->Advance(m_readCost);
+    }
+    auto result = pread(m_memFd, aBuffer, aBytes, static_cast<off_t>(aAddress));
+    return result < 0 ? 0 : static_cast<size_t>(result);
+}
+
+PMA::MemoryAddress SyntheticTargetFixture::ProcMemAccess::Dereference(PMA::MemoryAddress aAddress,
+                                                                      const PMA::MultiLevelPointer& aMlp)
+{
+    // First offset is applied to aAddress, every following one to the pointer read from the previous level
+    for (size_t i = 0; i < aMlp.size(); ++i)
+    {
+        if (i > 0)
+        {
+            PMA::MemoryAddress next = 0;
+            Read(aAddress, &next, sizeof(next));
+            aAddress = next;
+        }
+        aAddress += aMlp[i];
+    }
+    return aAddress;
+}
+
+bool SyntheticTargetFixture::ProcMemAccess::IsValid() const
+{
+    return kill(m_pid, 0) == 0;
+}
+
+void SyntheticTargetFixture::LaunchTarget(const TargetOptions& aOptions)
+{
+    int pipeFds[2];
+    ASSERT_EQ(pipe(pipeFds), 0);
+
+    std::vector<std::string> args = {GE_SYNTHETIC_TARGET_PATH, std::format("--list={}", aOptions.m_listSize),
+                                     std::format("--table={}", aOptions.m_tableSize),
+                                     std::format("--churn={}", aOptions.m_churnPerSecond),
+                                     std::format("--tick-us={}", aOptions.m_tickUs),
+                                     std::format("--log-per-tick={}", aOptions.m_logPerTick),
+                                     std::format("--log-capacity={}", aOptions.m_logCapacity)};
+    std::vector<char*> argv;
+    for (auto& arg : args)
+    {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, pipeFds[0]);
+    pid_t pid = -1;
+    int spawnResult = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipeFds[1]);
+    ASSERT_EQ(spawnResult, 0) << "Cannot launch " << argv[0];
+    m_targetPid = pid;
+
+    auto* out = fdopen(pipeFds[0], "r");
+    char line[128] = {};
+    ASSERT_NE(fgets(line, sizeof(line), out), nullptr);
+    fclose(out);
+    ASSERT_EQ(std::sscanf(line, "roots 0x%zx", &m_roots), 1) << line;
+}
+
+void SyntheticTargetFixture::TearDown()
+{
+    if (m_targetPid > 0)
+    {
+        kill(m_targetPid, SIGKILL);
+        waitpid(m_targetPid, nullptr, 0);
+        m_targetPid = -1;
+    }
+}
+
+SyntheticTargetFixture::RunStats SyntheticTargetFixture::Run(const TargetOptions& aOptions, size_t aFrames,
+                                                             const std::function<void(GE::MemoryProcessor&)>& aConfigure)
+{
+    using namespace GE::Synthetic;
+    using Clock = std::chrono::steady_clock;
+
+    auto access = std::make_shared<ProcMemAccess>(m_targetPid);
+    auto processor = GE::MemoryProcessor::Create(GetConsoleLogger());
+    if (m_virtualClock)
+    {
+        access->m_clock = m_virtualClock;
+        access->m_readCost = m_readCost;
+        processor->SetClock(m_virtualClock);
+    }
+    processor->RegisterLayout("Roots", GE::Layout::MakeConsecutive()
+                                           ->SetTotalSize(sizeof(Roots))
+                                           .AddPointerOffsets(offsetof(Roots, m_listHead), std::string("Node"))
+                                           .AddPointerOffsets(offsetof(Roots, m_table), std::string("Table"))
+                                           .Build());
+    processor->RegisterLayout("Node", GE::Layout::MakeConsecutive()
+                                          ->SetTotalSize(sizeof(Node))
+                                          .AddPointerOffsets(offsetof(Node, m_next), std::string("Node"))
+                                          .Build());
+    processor->RegisterLayout("Table", GE::Layout::MakeConsecutive()
+                                           ->SetTotalSize(aOptions.m_tableSize * sizeof(Node*))
+                                           .AddPointerOffsets(size_t{0}, std::string("Node"), aOptions.m_tableSize)
+                                           .Build());
+
+    RunStats stats;
+    Clock::time_point frameStart;
+    std::vector<std::chrono::microseconds> latencies;
+    GE::MainLayoutCallbacks callbacks;
+    callbacks.m_baseLocator = [&](PMA::MemoryAccessPtr, const std::optional<PMA::MemoryAddress>&) {
+        frameStart = Clock::now();
+        if (++stats.m_frames == aFrames)
+        {
+            // Current frame is still finished and delivered
+            processor->RequestStop();
+        }
+        return m_roots;
+    };
+    processor->AddMainLayout("Roots", callbacks);
+
+    auto validate = [&stats](const Node* aNode) {
+        if (aNode->m_magic != kAliveMagic)
+        {
+            ++stats.m_danglingNodes;
+            return false;
+        }
+        if (aNode->m_counter != aNode->m_counterCopy)
+        {
+            ++stats.m_tornNodes;
+        }
+        return true;
+    };
+    // Ids are handed out in order, to the list first and to the table after it. The tick and the counters only grow.
+    uint64_t lastTick = 0;
+    std::vector<uint64_t> listCounters(aOptions.m_listSize, 0);
+    processor->SetUpdateCallback(
+        [&](const GE::DataAccessor& aData) {
+            const auto* roots = aData.Get<Roots>("Roots");
+            bool corrupt = roots->m_tick < lastTick;
+            lastTick = roots->m_tick;
+            // Dangling nodes can contain anything, never trust their links
+            size_t index = 0;
+            for (const auto* node = roots->m_listHead; node && index < aOptions.m_listSize; node = node->m_next, ++index)
+            {
+                if (validate(node))
+                {
+                    corrupt |= node->m_id != index + 1 || node->m_counter < listCounters[index];
+                    listCounters[index] = node->m_counter;
+                }
+            }
+            corrupt |= index != aOptions.m_listSize;
+            for (size_t i = 0; roots->m_table && i < aOptions.m_tableSize; ++i)
+            {
+                if (roots->m_table[i] && validate(roots->m_table[i]))
+                {
+                    // Churned entries get nodes with new ids
+                    auto id = roots->m_table[i]->m_id;
+                    corrupt |= aOptions.m_churnPerSecond ? id <= aOptions.m_listSize : id != aOptions.m_listSize + i + 1;
+                }
+            }
+            stats.m_corruptFrames += corrupt;
+            latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - frameStart));
+        },
+        2, 1);
+    if (aConfigure)
+    {
+        aConfigure(*processor);
+    }
+
+    // Short runs can finish before Start would notice that the processor was running
+    std::atomic<bool> stopped = false;
+    auto runningToken = processor->OnRunningChanged([&stopped](bool aRunning) {
+        stopped = !aRunning;
+    });
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::seconds(30);
+    processor->RequestStart(access);
+    while (!stopped && Clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bool finished = stopped;
+    processor->Stop();
+    EXPECT_TRUE(finished) << "Only " << stats.m_frames << " of " << aFrames << " frames were read";
+    stats.m_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    stats.m_updates = latencies.size();
+    stats.m_framesPerSecond = stats.m_frames / elapsed;
+    stats.m_readsPerFrame = stats.m_frames ? static_cast<double>(access->m_reads) / stats.m_frames : 0.0;
+    stats.m_bytesPerFrame = stats.m_frames ? static_cast<double>(access->m_bytes) / stats.m_frames : 0.0;
+    if (!latencies.empty())
+    {
+        std::ranges::sort(latencies);
+        stats.m_p99FrameLatency = latencies[(latencies.size() - 1) * 99 / 100];
+    }
+    return stats;
+}
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "ge_fixture.h"
+#include "game_enhancer/clock.h"
+#include "game_enhancer/memory_processor.h"
+#include "pma/memory_access.h"
+
+/*
+ * Launches the bundled synthetic target (Linux only) and reads it through /proc/<pid>/mem.
+ */
+class SyntheticTargetFixture : public GEFixture
+{
+protected:
+    struct TargetOptions
+    {
+        size_t m_listSize = 256;
+        size_t m_tableSize = 4096;
+        size_t m_churnPerSecond = 0;
+        size_t m_tickUs = 1000;
+        size_t m_logPerTick = 0;
+        size_t m_logCapacity = 0;
+    };
+
+    struct RunStats
+    {
+        size_t m_frames = 0;
+        size_t m_updates = 0;
+        double m_framesPerSecond = 0.0;
+        double m_readsPerFrame = 0.0;
+        double m_bytesPerFrame = 0.0;
+        std::chrono::microseconds m_p99FrameLatency{};
+        std::chrono::milliseconds m_elapsed{};
+        size_t m_tornNodes = 0;
+        size_t m_danglingNodes = 0;
+        // Frames whose content breaks the invariants of the target, ids out of sequence or counters going backwards
+        size_t m_corruptFrames = 0;
+    };
+
+    class ProcMemAccess : public PMA::MemoryAccess
+    {
+        int m_pid = -1;
+        int m_memFd = -1;
+
+    public:
+        std::atomic<size_t> m_reads = 0;
+        std::atomic<size_t> m_bytes = 0;
+        // Simulated cost of a single read, advances m_clock
+        GE::VirtualClockPtr m_clock;
+        std::chrono::nanoseconds m_readCost{};
+
+        ProcMemAccess(int aPid);
+        ~ProcMemAccess();
+
+        size_t Read(PMA::MemoryAddress aAddress, void* aBuffer, size_t aBytes) override;
+        PMA::MemoryAddress Dereference(PMA::MemoryAddress aAddress, const PMA::MultiLevelPointer& aMlp) override;
+        bool IsValid() const override;
+    };
+
+    int m_targetPid = -1;
+    PMA::MemoryAddress m_roots = 0;
+    // When set, Run reads on this clock and every read advances it by m_readCost, so frames take the same time every run
+    GE::VirtualClockPtr m_virtualClock;
+    std::chrono::nanoseconds m_readCost{};
+
+    void LaunchTarget(const TargetOptions& aOptions);
+    void TearDown() override;
+
+    /*
+     * Reads aFrames frames of the target with a fresh MemoryProcessor and validates every node of every frame.
+     * Fails the test when the frames are not read within 30 seconds.
+     */
+    RunStats Run(const TargetOptions& aOptions, size_t aFrames, const std::function<void(GE::MemoryProcessor&)>& aConfigure = {});
+};
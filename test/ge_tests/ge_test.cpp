@@ -1,13 +1,48 @@
 #include "ge_test.h"
 
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <thread>
 #include <utility>
 
+#ifdef __linux__
+#include <csignal>
+
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef GE_SYNTHETIC_TARGET_PATH
+#include "synthetic_target.h"
+#endif
+
 #include "game_enhancer/achis/achievement.h"
+#include "game_enhancer/achis/achievement_journal.h"
 #include "game_enhancer/achis/achievement_manager.h"
+#include "game_enhancer/achis/achievement_store.h"
+#include "game_enhancer/achis/condition_expression.h"
+#include "game_enhancer/achis/save_writer.h"
+#include "game_enhancer/achis/tracker_columns.h"
 #include "game_enhancer/backup/backup_engine.h"
+#include "game_enhancer/batch_reader.h"
+#include "game_enhancer/clock.h"
+#include "game_enhancer/impl/data_accessor.h"
+#include "game_enhancer/impl/layout/append_tracker.h"
+#include "game_enhancer/impl/layout/frame_history.h"
 #include "game_enhancer/impl/layout/frame_memory_storage.h"
+#include "game_enhancer/impl/utils/async_log.h"
+#include "game_enhancer/impl/utils/frame_diff.h"
 #include "game_enhancer/memory_layout_builder.h"
 #include "game_enhancer/memory_processor.h"
+#include "game_enhancer/tracer.h"
+#include "spdlog/sinks/ostream_sink.h"
 
 struct TestPD : public GE::BaseProgressData
 {
@@ -38,12 +73,11 @@ TEST_F(GE_Tests, Test)
     achiManager.Load("");
 
     auto achi1 = TestAchiBld("Test Achievement",
-                             [](TestPD& aData,
-                                std::unordered_map<GE::ConditionType, std::unordered_set<GE::ProgressTracker*>>& aTrackers) {
-                                 aTrackers[GE::ConditionType::Activator].insert(&aData.m_intTracker);
-                                 aTrackers[GE::ConditionType::Completer].insert(&aData.m_boolTracker);
-                                 aTrackers[GE::ConditionType::Failer].insert(&aData.m_countdownTracker);
-                                 aTrackers[GE::ConditionType::Failer].insert(&aData.m_floatTracker);
+                             [](TestPD& aData, GE::ConditionTrackers& aTrackers) {
+                                 aTrackers.Add(GE::ConditionType::Activator, &aData.m_intTracker);
+                                 aTrackers.Add(GE::ConditionType::Completer, &aData.m_boolTracker);
+                                 aTrackers.Add(GE::ConditionType::Failer, &aData.m_countdownTracker);
+                                 aTrackers.Add(GE::ConditionType::Failer, &aData.m_floatTracker);
                              })
                      .Update(GE::Status::Inactive,
                              [](const GE::DataAccessor& aDataAccess, const GE::None&, TestPD& aPD) {
@@ -55,4 +89,1616 @@ TEST_F(GE_Tests, Test)
                                  // Modify ProgressTracker assigned to Completer/Failer/Validator conditions
                              })
                      .Build(GetConsoleLogger());
-}
\ No newline at end of file
+}
+
+TEST_F(GE_Tests, ConditionCounters)
+{
+    using GE::ConditionType;
+    TestPD data;
+    GE::ConditionTrackers conditions;
+    conditions.Add(ConditionType::Completer, &data.m_intTracker);
+    conditions.Add(ConditionType::Completer, &data.m_boolTracker);
+    conditions.Add(ConditionType::Failer, &data.m_intTracker);
+    conditions.Add(ConditionType::Failer, &data.m_intTracker);
+    EXPECT_EQ(conditions.Get(ConditionType::Failer).size(), 1);
+    EXPECT_TRUE(conditions.AllCompleted(ConditionType::Activator));
+    EXPECT_FALSE(conditions.AnyCompleted(ConditionType::Failer));
+
+    data.m_intTracker += 10;
+    EXPECT_TRUE(conditions.AnyCompleted(ConditionType::Failer));
+    EXPECT_FALSE(conditions.AllCompleted(ConditionType::Completer));
+    data.m_intTracker += 1;
+    data.m_boolTracker = true;
+    EXPECT_TRUE(conditions.AllCompleted(ConditionType::Completer));
+    data.m_intTracker.SetTarget(20);
+    EXPECT_FALSE(conditions.AllCompleted(ConditionType::Completer));
+    EXPECT_FALSE(conditions.AnyCompleted(ConditionType::Failer));
+
+    // Assigned trackers stay assigned, but their completion changed behind the counters
+    data = TestPD();
+    conditions.Recount();
+    EXPECT_FALSE(conditions.AnyCompleted(ConditionType::Completer));
+    data.m_boolTracker = true;
+    EXPECT_TRUE(conditions.AnyCompleted(ConditionType::Completer));
+
+    GE::ConditionTrackers other;
+    EXPECT_THROW(other.Add(ConditionType::Activator, &data.m_boolTracker), std::runtime_error);
+    conditions.Clear();
+    other.Add(ConditionType::Activator, &data.m_boolTracker);
+    EXPECT_TRUE(other.AllCompleted(ConditionType::Activator));
+}
+
+TEST_F(GE_Tests, ModifiedTrackers)
+{
+    TestPD data;
+    std::vector<GE::ProgressTracker*> modified;
+    data.m_intTracker += 1;
+    data.m_intTracker += 1;
+    data.m_boolTracker = true;
+    data.ExtractModifiedTrackers(modified);
+    EXPECT_EQ(modified, (std::vector<GE::ProgressTracker*>{&data.m_intTracker, &data.m_boolTracker}));
+    data.ExtractModifiedTrackers(modified);
+    EXPECT_TRUE(modified.empty());
+
+    // Steady extraction alternates between two buffers
+    std::vector<GE::ProgressTracker**> buffers;
+    for (size_t i = 0; i < 6; ++i)
+    {
+        data.m_intTracker += 1;
+        data.ExtractModifiedTrackers(modified);
+        ASSERT_EQ(modified.size(), 1);
+        buffers.push_back(modified.data());
+    }
+    for (size_t i = 4; i < buffers.size(); ++i)
+    {
+        EXPECT_EQ(buffers[i], buffers[i - 2]);
+    }
+
+    // Reset progress data forgets modifications, its trackers can be modified again
+    data.m_intTracker += 1;
+    data = TestPD();
+    data.ExtractModifiedTrackers(modified);
+    EXPECT_TRUE(modified.empty());
+    data.m_intTracker += 1;
+    data.ExtractModifiedTrackers(modified);
+    EXPECT_EQ(modified, (std::vector<GE::ProgressTracker*>{&data.m_intTracker}));
+}
+
+TEST_F(GE_Tests, StatusCallbacks)
+{
+    auto accessor = MakeAccessor();
+
+    std::vector<std::string> calls;
+    auto record = [&calls](const std::string& aCall) {
+        return [&calls, aCall](const GE::DataAccessor&, const GE::None&, TestPD&) {
+            calls.push_back(aCall);
+        };
+    };
+    auto achievement = TestAchiBld("Status callbacks",
+                                   [](TestPD& aData, GE::ConditionTrackers& aTrackers) {
+                                       aTrackers.Add(GE::ConditionType::Activator, &aData.m_intTracker);
+                                       aTrackers.Add(GE::ConditionType::Completer, &aData.m_boolTracker);
+                                   })
+                           .Update(GE::Status::All, record("update all"))
+                           .Update(GE::Status::Active, record("update active"))
+                           .Update(GE::Status::Inactive,
+                                   [](const GE::DataAccessor&, const GE::None&, TestPD& aPD) {
+                                       aPD.m_intTracker += 10;
+                                   })
+                           .OnLeaving(GE::Status::Inactive, record("leaving inactive"))
+                           .OnEntering(GE::Status::Active, record("entering active"))
+                           .OnEntering(GE::Status::Completed, record("entering completed"))
+                           .OnEntering(GE::Status::All, record("entering all"))
+                           .Build(GetConsoleLogger());
+
+    achievement->Update(accessor, {});
+    EXPECT_EQ(calls, (std::vector<std::string>{"update all", "leaving inactive", "entering active"}));
+    calls.clear();
+    achievement->Update(accessor, {});
+    EXPECT_EQ(calls, (std::vector<std::string>{"update all", "update active"}));
+    EXPECT_THROW(TestAchiBld("Invalid", {}).Update(static_cast<GE::Status>(100), record("invalid")), std::out_of_range);
+}
+
+TEST_F(GE_Tests, AchievementStore)
+{
+    auto accessor = MakeAccessor();
+
+    // Achievement id activates after id % 5 + 1 updates and completes after 10
+    auto makeAchievements = []() {
+        GE::AchievementStoreBuilder<std::string> builder;
+        for (uint32_t id = 1; id <= 1000; ++id)
+        {
+            builder.Add(id, std::to_string(id));
+            builder.AddTracker(GE::ConditionType::Activator, id % 5 + 1);
+            builder.AddTracker(GE::ConditionType::Completer, 10);
+        }
+        builder.Update([](auto& aStore, std::span<const uint32_t> aIndices, const GE::DataAccessor&, const GE::None&) {
+            for (auto index : aIndices)
+            {
+                auto [first, last] = aStore.GetTrackers(index);
+                for (auto tracker = first; tracker < last; ++tracker)
+                {
+                    aStore.AddCurrent(tracker, 1);
+                }
+            }
+        });
+        return builder.Build();
+    };
+    auto achiManager = GE::AchievementManager<GE::StoredAchievement<std::string>>(
+        makeAchievements, "test_achievements_storage_path", GetConsoleLogger());
+    achiManager.Activate(makeAchievements());
+    const auto& achievements = achiManager.GetActiveAchievements();
+    auto count = [&achievements](GE::Status aStatus) {
+        return std::ranges::count_if(achievements, [aStatus](const auto& aEntry) {
+            return aEntry.second->GetStatus() == aStatus;
+        });
+    };
+    std::vector<std::pair<GE::Status, GE::Status>> changes;
+    auto token = achievements.at(3)->OnStatusChanged([&changes](GE::Status aNew, GE::Status aOld) {
+        changes.emplace_back(aNew, aOld);
+    });
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        achiManager.Update(accessor, {});
+    }
+    EXPECT_EQ(count(GE::Status::Active), 800);
+    EXPECT_EQ(count(GE::Status::Inactive), 200);
+    EXPECT_EQ(achievements.at(3)->GetMetadata(), "3");
+
+    achievements.at(2)->Pause(true);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        achiManager.Update(accessor, {});
+    }
+    EXPECT_EQ(count(GE::Status::Completed), 999);
+    EXPECT_EQ(achievements.at(2)->GetStatus(), GE::Status::Paused);
+    EXPECT_EQ(changes, (std::vector<std::pair<GE::Status, GE::Status>>{{GE::Status::Active, GE::Status::Inactive},
+                                                                        {GE::Status::Completed, GE::Status::Active}}));
+
+    achiManager.Save("store");
+    auto loaded = achiManager.Load("store");
+    EXPECT_EQ(loaded.at(1)->GetStatus(), GE::Status::Completed);
+    EXPECT_EQ(loaded.at(2)->GetStatus(), GE::Status::Inactive);
+    const auto& store = loaded.at(2)->GetStore();
+    EXPECT_EQ(store.GetCurrent(store.GetTrackers(loaded.at(2)->GetIndex()).first), 4);
+}
+
+TEST_F(GE_Tests, AchievementStorePreconditions)
+{
+    auto accessor = MakeAccessor();
+
+    std::vector<std::string> calls;
+    auto record = [&calls](const std::string& aCall) {
+        return [&calls, aCall](auto&, std::span<const uint32_t> aIndices, const GE::DataAccessor&, const GE::None&) {
+            calls.insert(calls.end(), aIndices.size(), aCall);
+        };
+    };
+    GE::AchievementStoreBuilder<std::string> builder;
+    builder.Add(1, "Gated");
+    auto precondition = builder.AddTracker(GE::ConditionType::Precondition, 1);
+    auto activator = builder.AddTracker(GE::ConditionType::Activator, 1);
+    auto completer = builder.AddTracker(GE::ConditionType::Completer, 1);
+    builder.Update(record("update all"))
+        .Update(GE::Status::Inactive, record("update inactive"))
+        .Update(GE::Status::Active, record("update active"));
+    auto achievements = builder.Build(GetConsoleLogger());
+    auto& achievement = *achievements.at(1);
+    auto& store = achievement.GetStore();
+    size_t progressCalls = 0;
+    auto progressToken = achievement.OnProgressMade([&progressCalls](std::span<GE::ProgressTracker* const>) {
+        ++progressCalls;
+    });
+    auto update = [&]() {
+        calls.clear();
+        achievement.Update(accessor, {});
+    };
+
+    // Progress made while the precondition fails is kept for the update which completes it
+    store.SetCurrent(activator, 1);
+    update();
+    EXPECT_EQ(calls, (std::vector<std::string>{"update all"}));
+    EXPECT_EQ(achievement.GetStatus(), GE::Status::Inactive);
+    EXPECT_EQ(progressCalls, 0);
+    store.SetCurrent(precondition, 1);
+    update();
+    EXPECT_EQ(calls, (std::vector<std::string>{"update all", "update inactive"}));
+    EXPECT_EQ(achievement.GetStatus(), GE::Status::Active);
+    EXPECT_EQ(progressCalls, 1);
+
+    store.SetCurrent(precondition, 0);
+    store.SetCurrent(completer, 1);
+    update();
+    EXPECT_EQ(calls, (std::vector<std::string>{"update all"}));
+    EXPECT_EQ(achievement.GetStatus(), GE::Status::Active);
+    store.SetCurrent(precondition, 1);
+    update();
+    EXPECT_EQ(calls, (std::vector<std::string>{"update all", "update active"}));
+    EXPECT_EQ(achievement.GetStatus(), GE::Status::Completed);
+    EXPECT_EQ(progressCalls, 2);
+    EXPECT_THROW(builder.Update(static_cast<GE::Status>(100), record("invalid")), std::out_of_range);
+}
+
+TEST_F(GE_Tests, ConditionExpressions)
+{
+    auto frames = std::make_shared<GE::FrameHistory>();
+    GE::DataAccessorImpl accessor(frames);
+    auto addFrame = [&, sequence = size_t{0}](int32_t aHealth, int32_t aGold, float aSpeed) mutable {
+        auto& frame = *frames->emplace_back(std::make_shared<GE::FrameMemoryStorage>());
+        frame.SetFrameInfo(sequence++, {});
+        auto* player = frame.Allocate(12, 0x1000);
+        std::memcpy(player, &aHealth, 4);
+        std::memcpy(player + 4, &aGold, 4);
+        std::memcpy(player + 8, &aSpeed, 4);
+        frame.SetLayoutBase("Player", player);
+    };
+
+    auto health = GE::Field<int32_t>("Player", 0);
+    auto goldGained = GE::Delta(GE::Field<int32_t>("Player", 4)) > 0;
+    auto evaluator = GE::ExpressionEvaluator::Create();
+    auto rich = evaluator->Add(health >= 100 && goldGained);
+    auto healthy = evaluator->Add(GE::InRange(health, 50, 150));
+    auto moving = evaluator->Add(goldGained || !(GE::Field<float>("Player", 8) < 1.5));
+    auto strong = evaluator->Add(GE::Field<int32_t>("Player", 0) >= 100);
+    auto missing = evaluator->Add(GE::Field<int32_t>("Missing", 0) == 0);
+    // Health, gold in both frames, speed and the missing field are loaded once, shared subexpressions compiled once
+    EXPECT_EQ(evaluator->GetFieldLoadCount(), 5);
+    EXPECT_EQ(evaluator->GetInstructionCount(), 11);
+
+    addFrame(120, 10, 2.0f);
+    evaluator->Evaluate(accessor);
+    EXPECT_FALSE(evaluator->IsTrue(rich));
+    EXPECT_TRUE(evaluator->IsTrue(healthy));
+    EXPECT_TRUE(evaluator->IsTrue(moving));
+    EXPECT_TRUE(evaluator->IsTrue(strong));
+    EXPECT_FALSE(evaluator->IsTrue(missing));
+
+    addFrame(160, 15, 1.0f);
+    evaluator->Evaluate(accessor);
+    EXPECT_TRUE(evaluator->IsTrue(rich));
+    EXPECT_FALSE(evaluator->IsTrue(healthy));
+    EXPECT_TRUE(evaluator->IsTrue(moving));
+
+    auto gold = evaluator->Add(GE::Field<int32_t>("Player", 4) + 1);
+    auto missingNe = evaluator->Add(GE::Field<int32_t>("Missing", 0) != 0);
+    auto goldNe = evaluator->Add(GE::Field<int32_t>("Player", 4) != 0);
+    evaluator->Evaluate(accessor);
+    EXPECT_EQ(evaluator->GetValue(gold), 16.0);
+    EXPECT_FALSE(evaluator->IsTrue(missingNe));
+    EXPECT_TRUE(evaluator->IsTrue(goldNe));
+    EXPECT_THROW(GE::Delta(health + 1), std::invalid_argument);
+}
+
+TEST_F(GE_Tests, TrackerColumns)
+{
+    // 37 trackers cover the vector blocks and the scalar tail
+    auto expected = [](auto aValue, auto aTarget, GE::CompareKind aKind) {
+        switch (aKind)
+        {
+        case GE::CompareKind::Less:
+            return aValue < aTarget;
+        case GE::CompareKind::Equal:
+            return aValue == aTarget;
+        case GE::CompareKind::LessEqual:
+            return aValue <= aTarget;
+        case GE::CompareKind::Greater:
+            return aValue > aTarget;
+        case GE::CompareKind::NotEqual:
+            return aValue < aTarget || aValue > aTarget;
+        default:
+            return aValue >= aTarget;
+        }
+    };
+    auto check = [&](auto& aColumns, auto aValue) {
+        for (uint32_t i = 0; i < 37; ++i)
+        {
+            aColumns.Add(10, 0, static_cast<GE::CompareKind>(i % 6 + 1));
+        }
+        auto values = aColumns.GetValues();
+        for (uint32_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = aValue(i);
+        }
+        aColumns.Evaluate();
+        for (uint32_t i = 0; i < aColumns.GetSize(); ++i)
+        {
+            EXPECT_EQ(aColumns.IsCompleted(i), expected(aColumns.GetValue(i), aColumns.GetTarget(i), aColumns.GetKind(i))) << i;
+        }
+    };
+    GE::TrackerColumns<int32_t> ints;
+    check(ints, [](uint32_t i) {
+        return static_cast<int32_t>(i * 7 % 21);
+    });
+    GE::TrackerColumns<float> floats;
+    check(floats, [](uint32_t i) {
+        return i % 5 == 0 ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(i * 7 % 21) / 2.0f + 5.0f;
+    });
+
+    // Views take effect right away, bulk writes with the next Evaluate
+    struct ColumnPD : GE::BaseProgressData
+    {
+        GE::ProgressTrackerIntColumn m_kills;
+
+        explicit ColumnPD(GE::TrackerColumns<int32_t>& aColumns)
+            : m_kills(this, "Kills", aColumns, 5)
+        {
+        }
+    };
+    ColumnPD data(ints);
+    GE::ConditionTrackers conditions;
+    conditions.Add(GE::ConditionType::Completer, &data.m_kills);
+    std::vector<GE::ProgressTracker*> modified;
+    data.m_kills += 5;
+    EXPECT_TRUE(conditions.AllCompleted(GE::ConditionType::Completer));
+    data.ExtractModifiedTrackers(modified);
+    EXPECT_EQ(modified.size(), 1);
+
+    ints.GetValues()[data.m_kills.GetIndex()] = 1;
+    EXPECT_TRUE(data.m_kills.IsCompleted());
+    ints.Evaluate();
+    EXPECT_FALSE(conditions.AllCompleted(GE::ConditionType::Completer));
+    EXPECT_EQ(data.m_kills.GetMessage(), "Kills: 1 / 5");
+    data.ExtractModifiedTrackers(modified);
+    EXPECT_EQ(modified, (std::vector<GE::ProgressTracker*>{&data.m_kills}));
+    ints.Evaluate();
+    data.ExtractModifiedTrackers(modified);
+    EXPECT_TRUE(modified.empty());
+
+    // Slots of destroyed trackers are reused
+    auto size = ints.GetSize();
+    std::optional<ColumnPD> temporary(ints);
+    temporary.reset();
+    ColumnPD other(ints);
+    EXPECT_EQ(ints.GetSize(), size + 1);
+}
+
+TEST_F(GE_Tests, AchievementJournal)
+{
+    auto path = std::filesystem::path("test_achievements_storage_path") / "raw.journal";
+    std::filesystem::create_directories(path.parent_path());
+    GE::AchievementJournal::States expected{{1, "c"}, {2, "99"}};
+    {
+        auto journal = GE::AchievementJournal::Create(path, 256, GetConsoleLogger());
+        journal->WriteCheckpoint({{1, "a"}, {2, "b"}});
+        journal->Append(1, "c");
+        journal->Flush();
+        EXPECT_EQ(GE::AchievementJournal::Read(path), (GE::AchievementJournal::States{{1, "c"}, {2, "b"}}));
+        for (int i = 0; i < 100; ++i)
+        {
+            journal->Append(2, std::to_string(i));
+            journal->Flush();
+        }
+        journal->WaitForCompaction();
+        journal->Flush();
+        journal->WaitForCompaction();
+        EXPECT_LT(journal->GetTailSize(), 256u);
+        EXPECT_EQ(GE::AchievementJournal::Read(path), expected);
+    }
+    // A record torn by a crash is ignored
+    std::ofstream(path, std::ios::binary | std::ios::app) << "torn";
+    EXPECT_EQ(GE::AchievementJournal::Read(path), expected);
+
+    // A failed compaction is retried only after another aCompactAfter bytes of deltas
+    auto failingPath = path.parent_path() / "failing.journal";
+    auto tempPath = failingPath;
+    tempPath += ".tmp";
+    std::filesystem::remove_all(tempPath);
+    {
+        auto journal = GE::AchievementJournal::Create(failingPath, 64, GetConsoleLogger());
+        journal->WriteCheckpoint({{1, "a"}});
+        // The temporary file cannot be written while a directory is in its place
+        std::filesystem::create_directories(tempPath / "blocker");
+        while (!journal->IsCompacting())
+        {
+            journal->Append(1, "b");
+            journal->Flush();
+        }
+        journal->WaitForCompaction();
+        auto failedAt = journal->GetTailSize();
+        while (journal->GetTailSize() < failedAt + 64)
+        {
+            EXPECT_FALSE(journal->IsCompacting());
+            journal->Append(1, "c");
+            journal->Flush();
+        }
+        EXPECT_TRUE(journal->IsCompacting());
+        journal->WaitForCompaction();
+        std::filesystem::remove_all(tempPath);
+    }
+    EXPECT_EQ(GE::AchievementJournal::Read(failingPath), (GE::AchievementJournal::States{{1, "c"}}));
+
+    struct JournalPD : public GE::BaseProgressData, public GE::PersistentData
+    {
+        GE::ProgressTrackerInt<> m_counter{this, "Counter", 5};
+        GE::ProgressTrackerBool m_gate{this, "Gate", true};
+
+        void Serialize(GE::BinWriter aOut) const override { aOut.Write(m_counter.GetCurrent()); }
+
+        void Deserialize(GE::BinReader aIn) override { m_counter = aIn.Read<int>(); }
+    };
+    using JournalAchiBld = GE::AchievementBuilder<std::string, JournalPD>;
+    using JournalAchiType = std::remove_reference_t<decltype(*std::declval<JournalAchiBld>().Build())>;
+
+    auto accessor = MakeAccessor();
+
+    // Every tenth achievement makes progress, achievement 55 while its precondition is unmet
+    auto makeAchievements = []() {
+        std::map<uint32_t, std::unique_ptr<JournalAchiType>> achis;
+        for (uint32_t id = 1; id <= 100; ++id)
+        {
+            achis[id] = JournalAchiBld(std::to_string(id),
+                                       [id](JournalPD& aData, auto& aTrackers) {
+                                           aTrackers.Add(GE::ConditionType::Activator, &aData.m_counter);
+                                           if (id == 55)
+                                           {
+                                               aTrackers.Add(GE::ConditionType::Precondition, &aData.m_gate);
+                                           }
+                                       })
+                            .Update(GE::Status::All,
+                                    [id](const GE::DataAccessor&, const GE::None&, JournalPD& aPD) {
+                                        if (id == 55)
+                                        {
+                                            aPD.m_counter += 1;
+                                        }
+                                    })
+                            .Update(GE::Status::Inactive,
+                                    [id](const GE::DataAccessor&, const GE::None&, JournalPD& aPD) {
+                                        if (id % 10 == 0)
+                                        {
+                                            aPD.m_counter += 1;
+                                        }
+                                    })
+                            .Build();
+        }
+        return achis;
+    };
+    auto achiManager = GE::AchievementManager<JournalAchiType>(makeAchievements, "test_achievements_storage_path",
+                                                               GetConsoleLogger());
+    auto journalPath = std::filesystem::path("test_achievements_storage_path") / "progress.journal";
+    achiManager.EnableJournal("progress");
+    achiManager.Activate(makeAchievements());
+    auto checkpointSize = std::filesystem::file_size(journalPath);
+    achiManager.Update(accessor, {});
+    auto deltaSize = std::filesystem::file_size(journalPath) - checkpointSize;
+    EXPECT_GT(deltaSize, 0u);
+    EXPECT_LT(deltaSize * 5, checkpointSize);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        achiManager.Update(accessor, {});
+    }
+
+    auto loaded = achiManager.LoadJournal("progress");
+    auto counter = [&loaded](uint32_t aId) {
+        auto progress = loaded.at(aId)->GetProgress(GE::ConditionType::Activator);
+        return static_cast<const GE::ProgressTrackerInt<>*>(progress[0])->GetCurrent();
+    };
+    EXPECT_EQ(counter(10), 3);
+    EXPECT_EQ(counter(11), 0);
+    EXPECT_EQ(counter(55), 3);
+}
+
+TEST_F(GE_Tests, AsyncSave)
+{
+    auto accessor = MakeAccessor();
+
+    // Odd achievements complete on the second update
+    auto makeAchievements = []() {
+        std::map<uint32_t, std::unique_ptr<TestAchiType>> achis;
+        for (uint32_t id = 1; id <= 50; ++id)
+        {
+            achis[id] = TestAchiBld(std::to_string(id),
+                                    [](TestPD& aData, auto& aTrackers) {
+                                        aTrackers.Add(GE::ConditionType::Activator, &aData.m_intTracker);
+                                        aTrackers.Add(GE::ConditionType::Completer, &aData.m_boolTracker);
+                                    })
+                            .Update(GE::Status::Inactive,
+                                    [id](const GE::DataAccessor&, const GE::None&, TestPD& aPD) {
+                                        aPD.m_intTracker += id % 2 ? 10 : 0;
+                                    })
+                            .Update(GE::Status::Active,
+                                    [](const GE::DataAccessor&, const GE::None&, TestPD& aPD) {
+                                        aPD.m_boolTracker = true;
+                                    })
+                            .Build();
+        }
+        return achis;
+    };
+    auto achiManager = GE::AchievementManager<TestAchiType>(makeAchievements, "test_achievements_storage_path",
+                                                            GetConsoleLogger());
+    achiManager.Activate(makeAchievements());
+    std::vector<std::shared_future<void>> saves;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        achiManager.Update(accessor, {});
+        saves.push_back(achiManager.SaveAsync("async"));
+    }
+    for (auto& save : saves)
+    {
+        EXPECT_NO_THROW(save.get());
+    }
+    EXPECT_FALSE(std::filesystem::exists("test_achievements_storage_path/async.tmp"));
+
+    achiManager.Save("sync");
+    std::ifstream async("test_achievements_storage_path/async", std::ios::binary);
+    std::ifstream sync("test_achievements_storage_path/sync", std::ios::binary);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(async), {}), std::string(std::istreambuf_iterator<char>(sync), {}));
+    auto loaded = achiManager.Load("async");
+    EXPECT_EQ(loaded.at(1)->GetStatus(), GE::Status::Completed);
+    EXPECT_EQ(loaded.at(2)->GetStatus(), GE::Status::Inactive);
+
+    // Only the latest of the writes queued behind each other is written
+    auto writer = GE::SaveWriter::Create(GetConsoleLogger());
+    std::vector<std::shared_future<void>> writes;
+    for (int i = 0; i < 100; ++i)
+    {
+        writes.push_back(writer->Write("test_achievements_storage_path/coalesced", std::to_string(i)));
+    }
+    writer->Wait();
+    for (auto& write : writes)
+    {
+        EXPECT_EQ(write.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    }
+    std::ifstream coalesced("test_achievements_storage_path/coalesced", std::ios::binary);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(coalesced), {}), "99");
+    EXPECT_THROW(writer->Write("test_achievements_storage_path/missing/save", "").get(), std::exception);
+}
+
+TEST_F(GE_Tests, AchievementDependencies)
+{
+    auto frames = std::make_shared<GE::FrameHistory>();
+    GE::DataAccessorImpl accessor(frames);
+    auto addFrame = [&, sequence = size_t{0}](std::optional<size_t> aChangedByte = {}) mutable {
+        const auto* previous = frames->empty() ? nullptr : frames->back().get();
+        auto& frame = *frames->emplace_back(std::make_shared<GE::FrameMemoryStorage>());
+        frame.SetFrameInfo(sequence++, {});
+        auto* root = frame.Allocate(16, 0x1000);
+        if (previous)
+        {
+            std::memcpy(root, previous->FindLayoutBase("Root"), 16);
+        }
+        if (aChangedByte)
+        {
+            root[*aChangedByte] = static_cast<uint8_t>(sequence);
+        }
+        frame.SetLayoutBase("Root", frame.ShareUnchanged(root, previous));
+    };
+
+    auto clock = GE::VirtualClock::Create();
+    std::map<std::string, size_t> updates;
+    auto makeAchievement = [&](const std::string& aName, std::optional<size_t> aOffset) {
+        auto builder = TestAchiBld(aName, [clock](TestPD& aData, auto& aTrackers) {
+            aData.m_countdownTracker.SetClock(clock);
+            aTrackers.Add(GE::ConditionType::Failer, &aData.m_countdownTracker);
+        });
+        builder.Update(GE::Status::All, [&updates, aName](const GE::DataAccessor&, const GE::None&, TestPD& aPD) {
+            ++updates[aName];
+            aPD.m_countdownTracker.Update();
+        });
+        if (aOffset)
+        {
+            builder.DependsOn("Root", *aOffset, 4);
+        }
+        return builder.Build();
+    };
+    auto achiManager = GE::AchievementManager<TestAchiType>(
+        []() {
+            return std::map<uint32_t, std::unique_ptr<TestAchiType>>();
+        },
+        "test_achievements_storage_path", GetConsoleLogger());
+    std::map<uint32_t, std::unique_ptr<TestAchiType>> achis;
+    achis[1] = makeAchievement("first", 0);
+    achis[2] = makeAchievement("second", 8);
+    achis[3] = makeAchievement("always", {});
+    achiManager.Activate(std::move(achis));
+
+    auto update = [&](std::map<std::string, size_t> aExpected) {
+        updates.clear();
+        achiManager.Update(accessor, {});
+        EXPECT_EQ(updates, aExpected);
+    };
+    addFrame();
+    update({{"first", 1}, {"second", 1}, {"always", 1}});
+    addFrame();
+    update({{"always", 1}});
+    addFrame(1);
+    update({{"first", 1}, {"always", 1}});
+    addFrame(9);
+    update({{"second", 1}, {"always", 1}});
+    // No new frame, nothing changed
+    update({{"always", 1}});
+    // Changes of skipped frames are unknown
+    addFrame();
+    addFrame();
+    update({{"first", 1}, {"second", 1}, {"always", 1}});
+
+    // Running timer makes its achievement due once per second
+    auto* timer = dynamic_cast<GE::ProgressTrackerTimer*>(
+        *achiManager.GetActiveAchievements().at(1)->GetProgress(GE::ConditionType::Failer).begin());
+    ASSERT_NE(timer, nullptr);
+    timer->Start();
+    addFrame();
+    update({{"always", 1}});
+    clock->Advance(std::chrono::seconds(1));
+    addFrame();
+    update({{"first", 1}, {"always", 1}});
+    // Progress of the timer activated the achievement, the new status gets its update
+    addFrame();
+    update({{"first", 1}, {"always", 1}});
+    EXPECT_EQ(achiManager.GetActiveAchievements().at(1)->GetStatus(), GE::Status::Active);
+    addFrame();
+    update({{"always", 1}});
+}
+
+TEST_F(GE_Tests, ParallelAchievementUpdates)
+{
+    auto accessor = MakeAccessor();
+
+    // Every achievement activates after a different number of updates
+    auto makeAchievements = []() {
+        std::map<uint32_t, std::unique_ptr<TestAchiType>> achis;
+        for (uint32_t id = 1; id <= 300; ++id)
+        {
+            achis[id] = TestAchiBld(std::to_string(id),
+                                    [](TestPD& aData, auto& aTrackers) {
+                                        aTrackers.Add(GE::ConditionType::Activator, &aData.m_intTracker);
+                                    })
+                            .Update(GE::Status::Inactive,
+                                    [id](const GE::DataAccessor&, const GE::None&, TestPD& aPD) {
+                                        aPD.m_intTracker += static_cast<int>(id % 7 + 1);
+                                    })
+                            .Build();
+        }
+        return achis;
+    };
+    auto run = [&](size_t aWorkers) {
+        std::vector<std::pair<uint32_t, GE::Status>> notifications;
+        std::vector<PMA::ScopedTokenPtr> tokens;
+        auto achiManager = GE::AchievementManager<TestAchiType>(makeAchievements, "test_achievements_storage_path",
+                                                                GetConsoleLogger());
+        achiManager.SetParallelUpdate(aWorkers, 16);
+        achiManager.Activate(makeAchievements());
+        for (const auto& [id, achievement] : achiManager.GetActiveAchievements())
+        {
+            tokens.push_back(achievement->OnStatusChanged([&notifications, id](GE::Status aNew, GE::Status) {
+                notifications.emplace_back(id, aNew);
+            }));
+            tokens.push_back(achievement->OnProgressMade([&notifications, id](const auto&) {
+                notifications.emplace_back(id, GE::Status::All);
+            }));
+        }
+        auto caller = std::this_thread::get_id();
+        tokens.push_back(achiManager.GetActiveAchievements().at(1)->OnProgressMade([caller](const auto&) {
+            EXPECT_EQ(std::this_thread::get_id(), caller);
+        }));
+        for (size_t i = 0; i < 10; ++i)
+        {
+            achiManager.Update(accessor, {});
+        }
+        return notifications;
+    };
+    auto serial = run(0);
+    auto parallel = run(4);
+    EXPECT_EQ(std::ranges::count(serial, GE::Status::Active, &std::pair<uint32_t, GE::Status>::second), 300);
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST_F(GE_Tests, HistoryTiers)
+{
+    using namespace std::chrono_literals;
+    auto frames = std::make_shared<GE::FrameHistory>();
+    std::vector<GE::HistoryTier> tiers{{100ms, 1}, {1000ms, 10}};
+    auto start = std::chrono::steady_clock::time_point{};
+    // 10ms per frame, 2s of frames
+    for (size_t i = 0; i < 200; ++i)
+    {
+        frames->emplace_back(std::make_shared<GE::FrameMemoryStorage>())->SetFrameInfo(i, start + i * 10ms);
+        GE::ApplyRetention(*frames, 2, tiers);
+    }
+    // Newest 11 frames from the 1st tier, every 10th frame of the last second from the 2nd
+    EXPECT_EQ(frames->size(), 11 + 9);
+    EXPECT_EQ(frames->back()->GetSequence(), 199);
+    EXPECT_EQ(frames->front()->GetSequence(), 100);
+
+    GE::DataAccessorImpl accessor(frames);
+    EXPECT_EQ(accessor.FindFrame(0ms), 0);
+    EXPECT_EQ(accessor.FindFrame(50ms), 5);
+    EXPECT_EQ((*frames)[frames->size() - 1 - accessor.FindFrame(500ms)]->GetSequence(), 150);
+    EXPECT_EQ(accessor.FindFrame(10s), frames->size() - 1);
+}
+
+TEST_F(GE_Tests, MemoryBudget)
+{
+    auto frames = std::make_shared<GE::FrameHistory>();
+    // Every frame shares one object with its predecessor and adds a fresh one
+    for (size_t i = 0; i < 10; ++i)
+    {
+        const auto* previous = frames->empty() ? nullptr : frames->back().get();
+        auto& frame = *frames->emplace_back(std::make_shared<GE::FrameMemoryStorage>());
+        frame.SetFrameInfo(i, {});
+        frame.ShareUnchanged(frame.Allocate(64, 0x1000), previous);
+        frame.ShareUnchanged(frame.Allocate(32, 0x2000 + i), previous);
+        frame.SetLayoutBytes("Root", frame.GetBytes());
+    }
+    const size_t shared = sizeof(GE::Metadata) + 64;
+    const size_t fresh = sizeof(GE::Metadata) + 32;
+    auto retained = GE::CountRetainedBytes(*frames);
+    EXPECT_EQ(retained.m_bytes, shared + 10 * fresh);
+    EXPECT_EQ(retained.m_bytesByLayout["Root"], shared + 10 * fresh);
+
+    // Successor of an evicted frame is counted whole
+    frames->erase(frames->begin() + 5);
+    EXPECT_EQ(GE::CountRetainedBytes(*frames).m_bytes, 2 * shared + 9 * fresh);
+
+    EXPECT_EQ(GE::ApplyMemoryBudget(*frames, 2, shared + 3 * fresh), 6);
+    EXPECT_EQ(frames->front()->GetSequence(), 7);
+    EXPECT_EQ(GE::ApplyMemoryBudget(*frames, 2, 0), 1);
+    EXPECT_EQ(frames->size(), 2);
+}
+
+/*
+ * Reads the memory of the test itself.
+ */
+class LocalMemoryAccess : public PMA::MemoryAccess
+{
+public:
+    std::atomic<size_t> m_reads = 0;
+
+    size_t Read(PMA::MemoryAddress aAddress, void* aBuffer, size_t aBytes) override
+    {
+        ++m_reads;
+        std::memcpy(aBuffer, reinterpret_cast<const void*>(aAddress), aBytes);
+        return aBytes;
+    }
+
+    PMA::MemoryAddress Dereference(PMA::MemoryAddress aAddress, const PMA::MultiLevelPointer& aMlp) override
+    {
+        for (size_t i = 0; i < aMlp.size(); ++i)
+        {
+            if (i > 0)
+            {
+                Read(aAddress, &aAddress, sizeof(aAddress));
+            }
+            aAddress += aMlp[i];
+        }
+        return aAddress;
+    }
+
+    bool IsValid() const override { return true; }
+};
+
+TEST_F(GE_Tests, ParallelSharedSubtrees)
+{
+    struct SharedNode
+    {
+        SharedNode* m_next = nullptr;
+        uint64_t m_id = 0;
+    };
+    // Every table entry points to one of a few shared nodes, all of them point to the same tail
+    constexpr size_t kTableSize = 4096;
+    constexpr size_t kShared = 8;
+    SharedNode tail{nullptr, 1000};
+    std::vector<SharedNode> shared(kShared);
+    for (size_t i = 0; i < kShared; ++i)
+    {
+        shared[i] = {&tail, i};
+    }
+    std::vector<SharedNode*> table(kTableSize);
+    for (size_t i = 0; i < kTableSize; ++i)
+    {
+        table[i] = &shared[i * 7 % kShared];
+    }
+    auto* tableAddress = table.data();
+
+    auto processor = GE::MemoryProcessor::Create(GetConsoleLogger());
+    processor->RegisterLayout("Table", GE::Layout::MakeConsecutive()
+                                           ->SetTotalSize(kTableSize * sizeof(SharedNode*))
+                                           .AddPointerOffsets(size_t{0}, std::string("Node"), kTableSize)
+                                           .Build());
+    processor->RegisterLayout("Node", GE::Layout::MakeConsecutive()
+                                          ->SetTotalSize(sizeof(SharedNode))
+                                          .AddPointerOffsets(offsetof(SharedNode, m_next), std::string("Node"))
+                                          .Build());
+    size_t readFrames = 0;
+    GE::MainLayoutCallbacks callbacks;
+    callbacks.m_baseLocator = [&](PMA::MemoryAccessPtr, const std::optional<PMA::MemoryAddress>&) {
+        ++readFrames;
+        return reinterpret_cast<PMA::MemoryAddress>(tableAddress);
+    };
+    processor->AddMainLayout("Table", callbacks);
+
+    constexpr size_t kFrames = 20;
+    size_t frames = 0;
+    size_t mismatches = 0;
+    std::promise<void> done;
+    processor->SetUpdateCallback(
+        [&](const GE::DataAccessor& aData) {
+            const auto* stored = aData.Get<SharedNode*>("Table");
+            std::vector<const SharedNode*> storedShared(kShared, nullptr);
+            for (size_t i = 0; i < kTableSize; ++i)
+            {
+                auto& first = storedShared[i * 7 % kShared];
+                first = first ? first : stored[i];
+                // Shared node and its tail were read once, every referrer got the same object
+                mismatches += stored[i] != first || stored[i]->m_id != i * 7 % kShared || stored[i]->m_next != stored[0]->m_next;
+            }
+            mismatches += stored[0]->m_next->m_id != tail.m_id || stored[0]->m_next->m_next != nullptr;
+            if (++frames == kFrames)
+            {
+                done.set_value();
+            }
+        },
+        2, 1);
+    processor->SetParallelRead(4, 16);
+
+    auto access = std::make_shared<LocalMemoryAccess>();
+    processor->Start(access);
+    auto finished = done.get_future().wait_for(std::chrono::seconds(10));
+    processor->Stop();
+    ASSERT_EQ(finished, std::future_status::ready);
+    EXPECT_EQ(mismatches, 0);
+    // Table, shared nodes and the tail are read once per frame, pointers of the table and the shared nodes on top
+    EXPECT_EQ(access->m_reads, readFrames * (1 + kTableSize + 2 * kShared + 1));
+}
+
+TEST_F(GE_Tests, DeduplicationAdjacentChange)
+{
+    struct Pair
+    {
+        uint8_t* m_left = nullptr;
+        uint8_t* m_right = nullptr;
+    };
+    // Both objects live next to each other, the target advances by changing them only
+    std::array<uint8_t, 128> objects{};
+    Pair pair{objects.data(), objects.data() + 64};
+    auto* pairAddress = &pair;
+
+    auto processor = GE::MemoryProcessor::Create(GetConsoleLogger());
+    processor->RegisterLayout("Pair", GE::Layout::MakeConsecutive()
+                                          ->SetTotalSize(sizeof(Pair))
+                                          .AddPointerOffsets(offsetof(Pair, m_left), size_t{64})
+                                          .AddPointerOffsets(offsetof(Pair, m_right), size_t{64})
+                                          .Build());
+    size_t frames = 0;
+    size_t enablerCalls = 0;
+    GE::MainLayoutCallbacks callbacks;
+    callbacks.m_baseLocator = [&](PMA::MemoryAccessPtr, const std::optional<PMA::MemoryAddress>&) {
+        // Odd frames advance the target, even ones repeat the previous frame and are dropped
+        switch (++frames)
+        {
+        case 3:
+            pair.m_right[20] = 1;
+            break;
+        case 5:
+            // Change of the right object starts where the change of the left one ends
+            std::fill_n(pair.m_left, 8, 2);
+            std::fill_n(pair.m_right + 8, 8, 2);
+            break;
+        case 6:
+            processor->RequestStop();
+            break;
+        }
+        return reinterpret_cast<PMA::MemoryAddress>(pairAddress);
+    };
+    callbacks.m_enabler = [&](const GE::DataAccessor&, GE::Enabler&) {
+        ++enablerCalls;
+    };
+    processor->AddMainLayout("Pair", callbacks);
+    std::vector<std::array<uint8_t, 128>> updates;
+    processor->SetUpdateCallback(
+        [&](const GE::DataAccessor& aData) {
+            const auto* stored = aData.Get<Pair>("Pair");
+            auto& update = updates.emplace_back();
+            std::copy_n(stored->m_left, 64, update.begin());
+            std::copy_n(stored->m_right, 64, update.begin() + 64);
+        },
+        1, 1);
+    processor->SetFrameDeduplication(true);
+
+    std::promise<void> stopped;
+    auto runningToken = processor->OnRunningChanged([&stopped](bool aRunning) {
+        if (!aRunning)
+        {
+            stopped.set_value();
+        }
+    });
+    processor->RequestStart(std::make_shared<LocalMemoryAccess>());
+    ASSERT_EQ(stopped.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    processor->Stop();
+
+    EXPECT_EQ(frames, 6);
+    ASSERT_EQ(updates.size(), 3);
+    EXPECT_EQ(updates[0][64 + 20], 0);
+    EXPECT_EQ(updates[1][64 + 20], 1);
+    EXPECT_EQ(updates.back(), objects);
+    // Enablers saw only the kept frames
+    EXPECT_EQ(enablerCalls, 3);
+}
+
+TEST_F(GE_Tests, DynamicHeadEdit)
+{
+    struct Holder
+    {
+        uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+    };
+    // Dynamic object whose head is edited once appended reads would be trusted, returns frames with stale data
+    auto run = [](bool aAppendOnly, bool aGrow) {
+        std::array<uint8_t, 256> data{};
+        Holder holder{data.data(), aGrow ? 64 : data.size()};
+        auto* holderAddress = &holder;
+
+        auto processor = GE::MemoryProcessor::Create(GetConsoleLogger());
+        std::function<size_t(Holder*)> sizeProvider = [](Holder* aHolder) {
+            return aHolder->m_size;
+        };
+        auto builder = GE::Layout::MakeConsecutive();
+        builder->SetTotalSize(sizeof(Holder)).AddPointerOffsets(offsetof(Holder, m_data), sizeProvider);
+        if (aAppendOnly)
+        {
+            builder->SetAppendOnly();
+        }
+        processor->RegisterLayout("Holder", builder->Build());
+        constexpr size_t kFrames = 20;
+        size_t frames = 0;
+        GE::MainLayoutCallbacks callbacks;
+        callbacks.m_baseLocator = [&](PMA::MemoryAccessPtr, const std::optional<PMA::MemoryAddress>&) {
+            if (++frames > 2 * GE::AppendTracker::kTrustAfter)
+            {
+                data[0] = static_cast<uint8_t>(frames);
+            }
+            if (aGrow && frames > 1)
+            {
+                holder.m_size += 8;
+            }
+            if (frames == kFrames)
+            {
+                processor->RequestStop();
+            }
+            return reinterpret_cast<PMA::MemoryAddress>(holderAddress);
+        };
+        processor->AddMainLayout("Holder", callbacks);
+        size_t updates = 0;
+        size_t mismatches = 0;
+        processor->SetUpdateCallback(
+            [&](const GE::DataAccessor& aData) {
+                const auto* stored = aData.Get<Holder>("Holder");
+                ++updates;
+                mismatches += !std::equal(data.begin(), data.begin() + holder.m_size, stored->m_data);
+            },
+            1, 1);
+
+        std::promise<void> stopped;
+        auto runningToken = processor->OnRunningChanged([&stopped](bool aRunning) {
+            if (!aRunning)
+            {
+                stopped.set_value();
+            }
+        });
+        processor->RequestStart(std::make_shared<LocalMemoryAccess>());
+        EXPECT_EQ(stopped.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+        processor->Stop();
+        EXPECT_EQ(updates, kFrames);
+        return mismatches;
+    };
+
+    // Dynamic data is fully read unless marked append-only
+    EXPECT_EQ(run(false, true), 0);
+    // Append-only data of the same size is fully read
+    EXPECT_EQ(run(true, false), 0);
+    // Edits in place of growing append-only data are missed until the next full read
+    EXPECT_GT(run(true, true), 0);
+    EXPECT_THROW(GE::Layout::MakeConsecutive()->AddPointerOffsets(size_t{0}, std::string("Holder")).SetAppendOnly(),
+                 std::runtime_error);
+}
+
+TEST_F(GE_Tests, SharedBlocks)
+{
+    auto pool = std::make_shared<GE::BlockPool>();
+    auto fill = [](uint8_t* aData, uint8_t aValue) {
+        std::fill_n(aData, 16, aValue);
+    };
+
+    GE::FrameMemoryStorage first(pool);
+    auto* kept = first.Allocate(16, 0x100);
+    auto* edited = first.Allocate(16, 0x200);
+    fill(kept, 1);
+    fill(edited, 2);
+    EXPECT_EQ(first.ShareUnchanged(kept, nullptr), kept);
+    EXPECT_EQ(first.ShareUnchanged(edited, nullptr), edited);
+
+    GE::FrameMemoryStorage second(pool);
+    auto* keptAgain = second.Allocate(16, 0x100);
+    auto* editedAgain = second.Allocate(16, 0x200);
+    fill(keptAgain, 1);
+    fill(editedAgain, 3);
+    EXPECT_EQ(second.ShareUnchanged(keptAgain, &first), kept);
+    EXPECT_EQ(second.ShareUnchanged(editedAgain, &first), editedAgain);
+    EXPECT_EQ(second.FindObject(0x100).data(), kept);
+    EXPECT_EQ(second.GetBytes().m_bytes, 2 * (sizeof(GE::Metadata) + 16));
+    EXPECT_EQ(second.GetBytes().m_freshBytes, sizeof(GE::Metadata) + 16);
+
+    // The fresh block of the shared object went back to the pool and is handed out zeroed
+    GE::FrameMemoryStorage third(pool);
+    auto* reused = third.Allocate(16, 0x300);
+    EXPECT_EQ(reused, keptAgain);
+    EXPECT_TRUE(std::all_of(reused, reused + 16, [](uint8_t aByte) {
+        return aByte == 0;
+    }));
+    EXPECT_EQ(GE::GetMetadata(reused)->m_realAddress, 0x300);
+
+    // A block shared by two frames is pooled only after both are gone
+    std::optional<GE::FrameMemoryStorage> older(std::move(first));
+    std::optional<GE::FrameMemoryStorage> newer(std::move(second));
+    older.reset();
+    EXPECT_NE(third.Allocate(16, 0x400), kept);
+    newer.reset();
+    EXPECT_EQ(third.Allocate(16, 0x500), kept);
+}
+
+TEST_F(GE_Tests, FrameDiff)
+{
+    // Sizes around the 16/32 byte vector widths, differences at the edges and across lane boundaries
+    for (size_t size : {0, 1, 15, 16, 31, 32, 33, 64, 100})
+    {
+        std::vector<uint8_t> previous(size, 0xAA);
+        auto current = previous;
+        std::vector<GE::ChangedRange> expected;
+        for (size_t i = 0; i < size; i += 7)
+        {
+            auto length = std::min<size_t>(3, size - i);
+            std::fill_n(current.begin() + i, length, 0x55);
+            expected.push_back({i, length});
+        }
+        std::vector<GE::ChangedRange> ranges;
+        EXPECT_EQ(GE::DiffBytes(previous.data(), current.data(), size, ranges), size > 0);
+        ASSERT_EQ(ranges.size(), expected.size());
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            EXPECT_EQ(ranges[i].m_offset, expected[i].m_offset);
+            EXPECT_EQ(ranges[i].m_size, expected[i].m_size);
+        }
+    }
+
+    GE::FrameMemoryStorage first;
+    auto* data = first.Allocate(64, 0x1000);
+    EXPECT_EQ(first.ShareUnchanged(data, nullptr), data);
+    ASSERT_EQ(first.GetChangedRanges(data).size(), 1);
+    EXPECT_EQ(first.GetChangedRanges(data)[0].m_size, 64);
+
+    GE::FrameMemoryStorage second;
+    auto* same = second.Allocate(64, 0x1000);
+    EXPECT_EQ(second.ShareUnchanged(same, &first), data);
+    EXPECT_TRUE(second.GetChangedRanges(data).empty());
+
+    GE::FrameMemoryStorage third;
+    auto* changed = third.Allocate(64, 0x1000);
+    changed[40] = 1;
+    EXPECT_EQ(third.ShareUnchanged(changed, &second), changed);
+    EXPECT_TRUE(GE::GetMetadata(changed)->m_dirty);
+    ASSERT_EQ(third.GetChangedRanges(changed).size(), 1);
+    EXPECT_EQ(third.GetChangedRanges(changed)[0].m_offset, 40);
+
+    // Change of an object starts exactly where the change of the previous object ended, it must stay its own range
+    GE::FrameMemoryStorage before;
+    auto* left = before.Allocate(64, 0x2000);
+    auto* right = before.Allocate(64, 0x3000);
+    before.ShareUnchanged(left, nullptr);
+    before.ShareUnchanged(right, nullptr);
+    GE::FrameMemoryStorage after;
+    auto* leftChanged = after.Allocate(64, 0x2000);
+    auto* rightChanged = after.Allocate(64, 0x3000);
+    std::fill_n(leftChanged, 8, 1);
+    std::fill_n(rightChanged + 8, 8, 1);
+    EXPECT_EQ(after.ShareUnchanged(leftChanged, &before), leftChanged);
+    EXPECT_EQ(after.ShareUnchanged(rightChanged, &before), rightChanged);
+    ASSERT_EQ(after.GetChangedRanges(leftChanged).size(), 1);
+    EXPECT_EQ(after.GetChangedRanges(leftChanged)[0].m_size, 8);
+    ASSERT_EQ(after.GetChangedRanges(rightChanged).size(), 1);
+    EXPECT_EQ(after.GetChangedRanges(rightChanged)[0].m_offset, 8);
+    EXPECT_EQ(after.GetChangedRanges(rightChanged)[0].m_size, 8);
+}
+
+TEST_F(GE_Tests, Tracer)
+{
+    GE::Tracer::Clear();
+    {
+        GE::TraceSpan disabled("Disabled");
+    }
+    GE::Tracer::SetEnabled(true);
+    {
+        GE::TraceSpan frame("Frame");
+        GE::TraceSpan layout("ReadLayout", "Layout \"quoted\"");
+    }
+    std::string workerTrace;
+    std::thread([&workerTrace]() {
+        // Overflow the ring, only the newest spans are kept
+        for (size_t i = 0; i < GE::Tracer::kEventsPerThread + 10; ++i)
+        {
+            GE::TraceSpan span(i < 10 ? "Overwritten" : "Worker");
+        }
+        std::ostringstream out;
+        GE::Tracer::WriteChromeTrace(out);
+        workerTrace = out.str();
+    }).join();
+    GE::Tracer::SetEnabled(false);
+
+    size_t workerSpans = 0;
+    for (auto pos = workerTrace.find("\"Worker\""); pos != std::string::npos; pos = workerTrace.find("\"Worker\"", pos + 1))
+    {
+        ++workerSpans;
+    }
+    EXPECT_EQ(workerSpans, GE::Tracer::kEventsPerThread);
+    EXPECT_EQ(workerTrace.find("Overwritten"), std::string::npos);
+
+    // The buffer of the worker is released with its thread
+    std::ostringstream out;
+    GE::Tracer::WriteChromeTrace(out);
+    auto trace = out.str();
+    EXPECT_TRUE(trace.starts_with("{\"traceEvents\":["));
+    EXPECT_NE(trace.find("\"name\":\"Frame\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"detail\":\"Layout \\\"quoted\\\"\""), std::string::npos);
+    EXPECT_EQ(trace.find("Worker"), std::string::npos);
+    EXPECT_EQ(trace.find("Disabled"), std::string::npos);
+
+    GE::Tracer::Clear();
+    std::ostringstream cleared;
+    GE::Tracer::WriteChromeTrace(cleared);
+    EXPECT_EQ(cleared.str().find("Frame"), std::string::npos);
+}
+
+TEST_F(GE_Tests, AsyncLog)
+{
+    std::ostringstream out;
+    auto logger = std::make_shared<spdlog::logger>("async", std::make_shared<spdlog::sinks::ostream_sink_mt>(out));
+    logger->set_pattern("%t %l %v");
+    logger->set_level(spdlog::level::debug);
+    auto caller = std::to_string(spdlog::details::os::thread_id());
+    size_t dropped = 0;
+    {
+        GE::AsyncLog log(logger, 4);
+        log.info("Layout {} read in {} us", std::string("Temporary"), 42);
+        // Leave the background thread time to take it, the destructor drains the rest on this thread
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        log.trace("Below logger level");
+        for (int i = 0; i < 100; ++i)
+        {
+            log.debug("Flood {}", i);
+        }
+        // Warnings are not dropped when the ring is full and not truncated
+        for (int i = 0; i < 100; ++i)
+        {
+            log.warn("Short warning {}", i);
+        }
+        std::string layout(100, 'L');
+        for (int i = 0; i < 10; ++i)
+        {
+            log.warn("Warning {} for {}", i, layout);
+        }
+        dropped = log.GetDroppedCount();
+    }
+    auto text = out.str();
+    // Formatted by the background thread
+    EXPECT_NE(text.find("info Layout Temporary read in 42 us"), std::string::npos);
+    EXPECT_EQ(text.find(caller + " info Layout Temporary"), std::string::npos);
+    EXPECT_EQ(text.find("Below logger level"), std::string::npos);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_NE(text.find(std::format("warning Short warning {}\n", i)), std::string::npos);
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_NE(text.find(std::format("{} warning Warning {} for {}\n", caller, i, std::string(100, 'L'))),
+                  std::string::npos);
+    }
+    EXPECT_EQ(static_cast<size_t>(std::ranges::count(text, '\n')), 211 - dropped + (dropped ? 1 : 0));
+}
+
+TEST_F(GE_Tests, VirtualClock)
+{
+    using namespace std::chrono_literals;
+    auto clock = GE::VirtualClock::Create();
+    TestPD data;
+    data.m_countdownTracker.SetClock(clock);
+    data.m_countdownTracker.Start();
+
+    clock->Advance(90s);
+    data.m_countdownTracker.Update();
+    EXPECT_EQ(data.m_countdownTracker.GetCurrent(), 90);
+
+    data.m_countdownTracker.Pause();
+    clock->SleepUntil(clock->Now() + 60s);
+    // Clock never goes back
+    clock->SleepUntil(clock->Now() - 30s);
+    data.m_countdownTracker.Pause(false);
+    data.m_countdownTracker.Update();
+    EXPECT_EQ(data.m_countdownTracker.GetCurrent(), 90);
+
+    clock->Advance(510s);
+    data.m_countdownTracker.Update();
+    EXPECT_TRUE(data.m_countdownTracker.IsCompleted());
+    EXPECT_FALSE(data.m_countdownTracker.IsRunning());
+}
+
+#ifdef __linux__
+TEST_F(GE_Tests, ProcMemBatchReader)
+{
+    // Forked child has the same address space layout, so the parent knows where to read
+    std::vector<uint32_t> values(4096);
+    int pipeFds[2];
+    ASSERT_EQ(pipe(pipeFds), 0);
+    pid_t child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0)
+    {
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = static_cast<uint32_t>(i * 3);
+        }
+        char ready = 1;
+        write(pipeFds[1], &ready, 1);
+        pause();
+        _exit(0);
+    }
+    char ready = 0;
+    ASSERT_EQ(read(pipeFds[0], &ready, 1), 1);
+
+    auto reader = GE::BatchReader::CreateProcMemReader(child, 16);
+    std::vector<uint32_t> result(values.size());
+    std::vector<size_t> bytesRead(values.size() / 64);
+    for (size_t i = 0; i < bytesRead.size(); ++i)
+    {
+        reader->Queue(reinterpret_cast<PMA::MemoryAddress>(values.data() + i * 64), result.data() + i * 64,
+                      64 * sizeof(uint32_t), &bytesRead[i]);
+    }
+    size_t invalidRead = 1;
+    reader->Queue(0, result.data(), sizeof(uint32_t), &invalidRead);
+    reader->Flush();
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+
+    EXPECT_EQ(invalidRead, 0);
+    for (size_t i = 0; i < bytesRead.size(); ++i)
+    {
+        EXPECT_EQ(bytesRead[i], 64 * sizeof(uint32_t));
+    }
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        ASSERT_EQ(result[i], i * 3);
+    }
+}
+#endif
+
+#ifdef GE_SYNTHETIC_TARGET_PATH
+TEST_F(SyntheticTarget_Tests, Throughput)
+{
+    TargetOptions options;
+    LaunchTarget(options);
+    auto stats = Run(options, 100);
+
+    RecordProperty("frames_per_second", std::to_string(stats.m_framesPerSecond));
+    RecordProperty("reads_per_frame", std::to_string(stats.m_readsPerFrame));
+    RecordProperty("p99_frame_latency_us", std::to_string(stats.m_p99FrameLatency.count()));
+    GetConsoleLogger()->info("Throughput: {:.1f} fps, {:.1f} reads/frame, p99 latency {} us", stats.m_framesPerSecond,
+                             stats.m_readsPerFrame, stats.m_p99FrameLatency.count());
+
+    EXPECT_EQ(stats.m_frames, 100);
+    EXPECT_GT(stats.m_updates, 0);
+    EXPECT_EQ(stats.m_danglingNodes, 0);
+    EXPECT_EQ(stats.m_corruptFrames, 0);
+}
+
+TEST_F(SyntheticTarget_Tests, ChurnKeepsReading)
+{
+    TargetOptions options;
+    options.m_churnPerSecond = 20000;
+    LaunchTarget(options);
+    auto stats = Run(options, 100);
+
+    RecordProperty("torn_nodes", std::to_string(stats.m_tornNodes));
+    RecordProperty("dangling_nodes", std::to_string(stats.m_danglingNodes));
+    GetConsoleLogger()->info("Churn: {} frames, {} torn nodes, {} dangling nodes", stats.m_frames, stats.m_tornNodes,
+                             stats.m_danglingNodes);
+
+    // Freed and torn objects are expected, the processor must survive them without stopping
+    EXPECT_EQ(stats.m_frames, 100);
+    EXPECT_GT(stats.m_updates, 0);
+    EXPECT_EQ(stats.m_corruptFrames, 0);
+}
+
+TEST_F(SyntheticTarget_Tests, FrameDeduplication)
+{
+    using namespace GE::Synthetic;
+    // 10 ticks per second, read every millisecond
+    TargetOptions options{.m_listSize = 16, .m_tableSize = 16, .m_tickUs = 100'000};
+    LaunchTarget(options);
+
+    // Frames are read only once the tick moved. The probe has no tick to compare with during the first 3 frames, the
+    // remaining 7 wait for at least 6 full tick periods.
+    auto probed = Run(options, 10, [this](GE::MemoryProcessor& aProcessor) {
+        aProcessor.SetFrameDeduplication(true, GE::TickProbe{[this](PMA::MemoryAccessPtr) {
+            return m_roots + offsetof(Roots, m_tick);
+        }});
+    });
+    EXPECT_EQ(probed.m_frames, 10);
+    EXPECT_GE(probed.m_elapsed, std::chrono::milliseconds(600));
+
+    // Every frame is read, those without a new tick are dropped
+    auto compared = Run(options, 300, [](GE::MemoryProcessor& aProcessor) {
+        aProcessor.SetFrameDeduplication(true);
+    });
+    EXPECT_EQ(compared.m_frames, 300);
+    EXPECT_LE(compared.m_updates, compared.m_elapsed / std::chrono::milliseconds(100) + 2);
+    EXPECT_EQ(compared.m_tornNodes + probed.m_tornNodes, 0);
+    EXPECT_EQ(compared.m_corruptFrames + probed.m_corruptFrames, 0);
+}
+
+TEST_F(SyntheticTarget_Tests, FrameBudget)
+{
+    using namespace GE::Synthetic;
+    TargetOptions options;
+    LaunchTarget(options);
+    // Every read costs 1 us of virtual time, the budget runs out at the same read of every frame
+    m_virtualClock = GE::VirtualClock::Create();
+    m_readCost = std::chrono::microseconds(1);
+    auto full = Run(options, 20);
+
+    std::atomic<size_t> snapshots = 0;
+    std::atomic<size_t> staleLists = 0;
+    std::atomic<size_t> freshTables = 0;
+    auto budgeted = Run(options, 20, [&](GE::MemoryProcessor& aProcessor) {
+        aProcessor.RegisterLayout("Roots", GE::Layout::MakeConsecutive()
+                                               ->SetTotalSize(sizeof(Roots))
+                                               .AddPointerOffsets(offsetof(Roots, m_listHead), std::string("Node"))
+                                               .SetPointerPriority(GE::Layout::Priority::High)
+                                               .AddPointerOffsets(offsetof(Roots, m_table), std::string("Table"))
+                                               .SetPointerPriority(GE::Layout::Priority::Low)
+                                               .Build());
+        aProcessor.RegisterLayout("Node", GE::Layout::MakeConsecutive()
+                                              ->SetTotalSize(sizeof(Node))
+                                              .AddPointerOffsets(offsetof(Node, m_next), std::string("Node"))
+                                              .SetPointerPriority(GE::Layout::Priority::High)
+                                              .Build());
+        aProcessor.SetFrameBudget(std::chrono::microseconds(200));
+        aProcessor.AddUpdateConsumer({[&](const GE::DataAccessor& aData) {
+                                          // First frame has nothing to reuse and is read entirely
+                                          if (aData.GetNumberOfFrames() < 2)
+                                          {
+                                              return;
+                                          }
+                                          const auto* roots = aData.Get<Roots>("Roots");
+                                          staleLists += aData.IsStale(roots->m_listHead);
+                                          freshTables += !aData.IsStale(roots->m_table);
+                                          ++snapshots;
+                                      },
+                                      std::chrono::milliseconds(1)});
+    });
+    GetConsoleLogger()->info("FrameBudget: {:.1f} reads/frame, full read {:.1f} reads/frame", budgeted.m_readsPerFrame,
+                             full.m_readsPerFrame);
+    // The list of high priority is read before the budget runs out, the table of low priority is reused afterwards
+    EXPECT_GT(snapshots, 0);
+    EXPECT_EQ(staleLists, 0);
+    EXPECT_EQ(freshTables, 0);
+    EXPECT_GE(budgeted.m_readsPerFrame, 2 * options.m_listSize);
+    EXPECT_LT(budgeted.m_readsPerFrame, full.m_readsPerFrame / 2);
+    EXPECT_EQ(budgeted.m_danglingNodes, 0);
+    EXPECT_EQ(budgeted.m_corruptFrames, 0);
+}
+
+TEST_F(SyntheticTarget_Tests, UpdateConsumers)
+{
+    using namespace GE::Synthetic;
+    TargetOptions options{.m_listSize = 16, .m_tableSize = 16};
+    LaunchTarget(options);
+
+    std::atomic<size_t> hudUpdates = 0;
+    std::atomic<size_t> slowUpdates = 0;
+    std::atomic<size_t> historyMisses = 0;
+    auto stats = Run(options, 1000, [&](GE::MemoryProcessor& aProcessor) {
+        aProcessor.AddUpdateConsumer({[&](const GE::DataAccessor& aData) {
+                                          if (aData.GetNumberOfFrames() < 4 || !aData.Get<Roots>("Roots", 3))
+                                          {
+                                              ++historyMisses;
+                                          }
+                                          ++hudUpdates;
+                                      },
+                                      std::chrono::milliseconds(30), 4});
+        aProcessor.AddUpdateConsumer({[&](const GE::DataAccessor& aData) {
+                                          // Frames of the snapshot stay valid while the reader moves on
+                                          const auto* roots = aData.Get<Roots>("Roots");
+                                          std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                                          if (aData.Get<Roots>("Roots") != roots)
+                                          {
+                                              ++historyMisses;
+                                          }
+                                          ++slowUpdates;
+                                      },
+                                      std::chrono::milliseconds(10)});
+    });
+    GetConsoleLogger()->info("UpdateConsumers: {} updates, {} HUD updates, {} slow updates", stats.m_updates,
+                             hudUpdates.load(), slowUpdates.load());
+    // Neither the reader nor the HUD waits for the slow consumer, each consumer runs about as often as it was due
+    const size_t hudDue = stats.m_elapsed / std::chrono::milliseconds(30);
+    const size_t slowDue = stats.m_elapsed / std::chrono::milliseconds(300);
+    EXPECT_EQ(stats.m_frames, 1000);
+    EXPECT_GT(stats.m_updates, 100);
+    EXPECT_GE(hudUpdates, hudDue * 2 / 3);
+    EXPECT_LE(hudUpdates, hudDue + 2);
+    EXPECT_GE(slowUpdates, std::max<size_t>(slowDue, 2) - 1);
+    EXPECT_LE(slowUpdates, slowDue + 1);
+    EXPECT_EQ(historyMisses, 0);
+    EXPECT_EQ(stats.m_corruptFrames, 0);
+}
+
+TEST_F(SyntheticTarget_Tests, MemoryBudget)
+{
+    TargetOptions options{.m_listSize = 64, .m_tableSize = 64};
+    LaunchTarget(options);
+
+    constexpr size_t kBudget = 256 * 1024;
+    GE::MemoryUsage usage;
+    auto stats = Run(options, 1000, [&](GE::MemoryProcessor& aProcessor) {
+        // Every frame of the last minute would be kept without the budget
+        aProcessor.SetHistoryTiers({{std::chrono::minutes(1), 1}});
+        aProcessor.SetMemoryBudget(kBudget);
+        aProcessor.AddUpdateConsumer({[&](const GE::DataAccessor&) { usage = aProcessor.GetMemoryUsage(); },
+                                      std::chrono::milliseconds(50)});
+    });
+    GetConsoleLogger()->info("MemoryBudget: {} frames read, {} frames holding {} bytes, peak {} bytes", stats.m_frames,
+                             usage.m_frames, usage.m_bytes, usage.m_peakBytes);
+    EXPECT_EQ(stats.m_frames, 1000);
+    EXPECT_LE(usage.m_peakBytes, kBudget);
+    EXPECT_GT(usage.m_frames, 2);
+    EXPECT_LT(usage.m_frames, stats.m_frames);
+    EXPECT_GT(usage.m_bytesByLayout["Roots"], 0);
+    EXPECT_EQ(stats.m_corruptFrames, 0);
+}
+
+TEST_F(SyntheticTarget_Tests, AppendOnlyLog)
+{
+    using namespace GE::Synthetic;
+    TargetOptions options{.m_listSize = 1, .m_tableSize = 1, .m_logPerTick = 256, .m_logCapacity = 4 * 1024 * 1024};
+    LaunchTarget(options);
+
+    std::atomic<size_t> corruptLogs = 0;
+    std::atomic<size_t> logSize = 0;
+    std::function<size_t(Roots*)> logSizeProvider = [](Roots* aRoots) {
+        return aRoots->m_logSize;
+    };
+    auto stats = Run(options, 1000, [&](GE::MemoryProcessor& aProcessor) {
+        aProcessor.RegisterLayout("Roots", GE::Layout::MakeConsecutive()
+                                               ->SetTotalSize(sizeof(Roots))
+                                               .AddPointerOffsets(offsetof(Roots, m_listHead), std::string("Node"))
+                                               .AddPointerOffsets(offsetof(Roots, m_table), std::string("Table"))
+                                               .AddPointerOffsets(offsetof(Roots, m_log), logSizeProvider)
+                                               .SetAppendOnly()
+                                               .Build());
+        aProcessor.AddUpdateConsumer({[&](const GE::DataAccessor& aData) {
+                                          const auto* roots = aData.Get<Roots>("Roots");
+                                          for (size_t i = 0; i < roots->m_logSize; ++i)
+                                          {
+                                              if (roots->m_log[i] != LogByte(i))
+                                              {
+                                                  ++corruptLogs;
+                                                  break;
+                                              }
+                                          }
+                                          logSize = roots->m_logSize;
+                                      },
+                                      std::chrono::milliseconds(20)});
+    });
+    GetConsoleLogger()->info("AppendOnlyLog: {:.1f} bytes read per frame, log of {} bytes", stats.m_bytesPerFrame,
+                             logSize.load());
+    // Whole log would be read every frame without appended reads, on average half of its final size
+    EXPECT_GT(logSize, 64 * 1024);
+    EXPECT_LT(stats.m_bytesPerFrame, 16 * 1024);
+    EXPECT_EQ(corruptLogs, 0);
+    EXPECT_EQ(stats.m_corruptFrames, 0);
+}
+
+TEST_F(SyntheticTarget_Tests, VirtualClock)
+{
+    TargetOptions options{.m_listSize = 16, .m_tableSize = 16};
+    LaunchTarget(options);
+
+    auto clock = GE::VirtualClock::Create();
+    auto stats = Run(options, 500, [&](GE::MemoryProcessor& aProcessor) {
+        aProcessor.SetClock(clock);
+    });
+    GetConsoleLogger()->info("VirtualClock: {:.1f} fps at 1 ms refresh rate", stats.m_framesPerSecond);
+    // Frames are read back to back, yet every frame advances the virtual time by exactly the refresh rate
+    EXPECT_GT(stats.m_framesPerSecond, 1000);
+    EXPECT_EQ(stats.m_frames, 500);
+    EXPECT_EQ(clock->Now().time_since_epoch(), std::chrono::milliseconds(stats.m_frames));
+    EXPECT_EQ(stats.m_corruptFrames, 0);
+}
+
+TEST_F(SyntheticTarget_Tests, Walkers)
+{
+    using namespace GE::Synthetic;
+    TargetOptions options{.m_listSize = 64, .m_tableSize = 512};
+    LaunchTarget(options);
+
+    auto walk = [&](const std::function<void(GE::MemoryProcessor&)>& aReadMode) {
+        size_t incomplete = 0;
+        size_t invalid = 0;
+        auto stats = Run(options, 300, [&](GE::MemoryProcessor& aProcessor) {
+            aProcessor.RegisterLayout("Roots", GE::Layout::MakeConsecutive()
+                                                   ->SetTotalSize(sizeof(Roots))
+                                                   .AddListWalk(offsetof(Roots, m_listHead), "Leaf", offsetof(Node, m_next),
+                                                                options.m_listSize)
+                                                   .AddBucketWalk(offsetof(Roots, m_table), "Leaf", options.m_tableSize,
+                                                                  offsetof(Node, m_next), options.m_tableSize)
+                                                   .Build());
+            aProcessor.RegisterLayout("Leaf", GE::Layout::MakeConsecutive()->SetTotalSize(sizeof(Node)).Build());
+            // Walked fields no longer point to a single node, validation of the fixture does not apply
+            aProcessor.SetUpdateCallback([&](const GE::DataAccessor& aData) {
+                const auto* roots = aData.Get<Roots>("Roots");
+                auto list = GE::GetWalkedNodes<Node>(roots->m_listHead);
+                auto table = GE::GetWalkedNodes<Node>(roots->m_table);
+                incomplete += list.size() != options.m_listSize || table.size() != options.m_tableSize;
+                for (size_t i = 0; i < list.size(); ++i)
+                {
+                    invalid += list[i]->m_magic != kAliveMagic || list[i]->m_id != i + 1;
+                }
+                for (size_t i = 0; i < table.size(); ++i)
+                {
+                    invalid += table[i]->m_magic != kAliveMagic || table[i]->m_id != options.m_listSize + i + 1;
+                }
+            },
+            2, 1);
+            aReadMode(aProcessor);
+        });
+        EXPECT_EQ(stats.m_frames, 300);
+        EXPECT_EQ(incomplete, 0);
+        EXPECT_EQ(invalid, 0);
+        return stats;
+    };
+    auto serial = walk([](GE::MemoryProcessor&) {});
+    auto parallel = walk([](GE::MemoryProcessor& aProcessor) {
+        aProcessor.SetParallelRead(2);
+    });
+    auto batched = walk([&](GE::MemoryProcessor& aProcessor) {
+        aProcessor.SetBatchReader(GE::BatchReader::CreateProcMemReader(m_targetPid));
+    });
+    GetConsoleLogger()->info("Walkers: {:.1f} / {:.1f} / {:.1f} fps serial / parallel / batched", serial.m_framesPerSecond,
+                             parallel.m_framesPerSecond, batched.m_framesPerSecond);
+}
+TEST_F(SyntheticTarget_Tests, ParallelRead)
+{
+    // Wide table is split between the workers, each frame costs thousands of reads
+    TargetOptions options;
+    LaunchTarget(options);
+
+    auto serial = Run(options, 30);
+    auto parallel = Run(options, 30, [](GE::MemoryProcessor& aProcessor) {
+        aProcessor.SetParallelRead(3);
+    });
+    GetConsoleLogger()->info("ParallelRead: {:.1f} / {:.1f} fps serial / parallel, {:.1f} / {:.1f} reads/frame",
+                             serial.m_framesPerSecond, parallel.m_framesPerSecond, serial.m_readsPerFrame,
+                             parallel.m_readsPerFrame);
+    EXPECT_EQ(parallel.m_frames, 30);
+    EXPECT_EQ(parallel.m_readsPerFrame, serial.m_readsPerFrame);
+    EXPECT_EQ(parallel.m_danglingNodes, 0);
+    EXPECT_EQ(parallel.m_corruptFrames, 0);
+}
+TEST_F(SyntheticTarget_Tests, BatchedPointerChains)
+{
+    TargetOptions options;
+    LaunchTarget(options);
+
+    auto direct = Run(options, 30);
+    auto batched = Run(options, 30, [this](GE::MemoryProcessor& aProcessor) {
+        aProcessor.SetBatchReader(GE::BatchReader::CreateProcMemReader(m_targetPid));
+    });
+    GetConsoleLogger()->info("BatchedPointerChains: {:.1f} / {:.1f} fps direct / batched, {:.1f} direct reads/frame",
+                             direct.m_framesPerSecond, batched.m_framesPerSecond, direct.m_readsPerFrame);
+    // Objects and the pointers leading to them are all read by the batch reader, the base locator needs no reads
+    EXPECT_EQ(batched.m_frames, 30);
+    EXPECT_EQ(batched.m_readsPerFrame, 0);
+    EXPECT_EQ(batched.m_danglingNodes, 0);
+    EXPECT_EQ(batched.m_corruptFrames, 0);
+}
+#endif
+
+
@@ -1,8 +1,26 @@
 #pragma once
 
 #include "fixtures/ge_fixture.h"
+#include "fixtures/synthetic_target_fixture.h"
+#include "game_enhancer/impl/data_accessor.h"
+#include "game_enhancer/impl/layout/frame_memory_storage.h"
 
 class GE_Tests : public GEFixture
 {
+protected:
+    // Accessor over a single empty frame that lives as long as the test
+    GE::DataAccessorImpl MakeAccessor()
+    {
+        m_frames = std::make_shared<GE::FrameHistory>();
+        m_frames->emplace_back(std::make_shared<GE::FrameMemoryStorage>());
+        return GE::DataAccessorImpl(m_frames);
+    }
+
+private:
+    std::shared_ptr<GE::FrameHistory> m_frames;
+};
+
+class SyntheticTarget_Tests : public SyntheticTargetFixture
+{
 protected:
 };
@@ -0,0 +1,170 @@
+#include "synthetic_target.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace GE::Synthetic;
+
+namespace
+{
+    struct Options
+    {
+        size_t m_listSize = 256;
+        size_t m_tableSize = 4096;
+        size_t m_churnPerSecond = 0;
+        size_t m_tickUs = 1000;
+        size_t m_logPerTick = 0;
+        size_t m_logCapacity = 0;
+    };
+
+    Options ParseOptions(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            auto separator = arg.find('=');
+            if (separator == std::string_view::npos)
+            {
+                continue;
+            }
+            auto key = arg.substr(0, separator);
+            auto value = std::stoull(std::string(arg.substr(separator + 1)));
+            if (key == "--list")
+            {
+                options.m_listSize = value;
+            }
+            else if (key == "--table")
+            {
+                options.m_tableSize = value;
+            }
+            else if (key == "--churn")
+            {
+                options.m_churnPerSecond = value;
+            }
+            else if (key == "--tick-us")
+            {
+                options.m_tickUs = value;
+            }
+            else if (key == "--log-per-tick")
+            {
+                options.m_logPerTick = value;
+            }
+            else if (key == "--log-capacity")
+            {
+                options.m_logCapacity = value;
+            }
+        }
+        return options;
+    }
+
+    Node* MakeNode(uint64_t aId)
+    {
+        auto* node = new Node;
+        node->m_id = aId;
+        return node;
+    }
+
+    void FreeNode(Node* aNode)
+    {
+        // Leave a recognizable pattern behind, readers holding a dangling pointer might still see it
+        aNode->m_magic = kFreedMagic;
+        delete aNode;
+    }
+
+    void Touch(Node* aNode)
+    {
+        volatile uint64_t* counter = &aNode->m_counter;
+        volatile uint64_t* copy = &aNode->m_counterCopy;
+        auto next = *counter + 1;
+        *counter = next;
+        std::memset(aNode->m_payload, static_cast<int>(next & 0xFF), kPayloadSize);
+        *copy = next;
+    }
+
+    bool ParentAlive(pid_t aParent)
+    {
+        return getppid() == aParent;
+    }
+}
+
+/*
+ * Synthetic game target for end-to-end tests. Builds a linked list and a pointer table of nodes, mutates them every tick and
+ * frees/reallocates table entries at the requested churn rate. Optionally appends to a log every tick.
+ * Runs until the parent process exits.
+ */
+int main(int argc, char** argv)
+{
+    auto options = ParseOptions(argc, argv);
+    auto parent = getppid();
+
+    uint64_t nextId = 1;
+    auto* roots = new Roots;
+    Node* tail = nullptr;
+    for (size_t i = 0; i < options.m_listSize; ++i)
+    {
+        auto* node = MakeNode(nextId++);
+        (tail ? tail->m_next : roots->m_listHead) = node;
+        tail = node;
+    }
+    roots->m_listSize = options.m_listSize;
+    roots->m_tableSize = options.m_tableSize;
+    roots->m_table = new Node*[options.m_tableSize];
+    for (size_t i = 0; i < options.m_tableSize; ++i)
+    {
+        roots->m_table[i] = MakeNode(nextId++);
+    }
+
+    roots->m_log = new uint8_t[options.m_logCapacity];
+
+    std::printf("roots 0x%zx\n", reinterpret_cast<size_t>(roots));
+    std::fflush(stdout);
+
+    std::mt19937_64 random(42);
+    double churnBudget = 0.0;
+    const double churnPerTick = static_cast<double>(options.m_churnPerSecond) * options.m_tickUs / 1'000'000.0;
+    auto nextTick = std::chrono::steady_clock::now();
+    while (ParentAlive(parent))
+    {
+        ++roots->m_tick;
+        for (auto* node = roots->m_listHead; node; node = node->m_next)
+        {
+            Touch(node);
+        }
+        for (size_t i = 0; i < roots->m_tableSize; ++i)
+        {
+            Touch(roots->m_table[i]);
+        }
+
+        if (roots->m_logSize + options.m_logPerTick <= options.m_logCapacity)
+        {
+            for (size_t i = roots->m_logSize; i < roots->m_logSize + options.m_logPerTick; ++i)
+            {
+                roots->m_log[i] = LogByte(i);
+            }
+            std::atomic_ref(roots->m_logSize).store(roots->m_logSize + options.m_logPerTick, std::memory_order_release);
+        }
+
+        churnBudget += churnPerTick;
+        for (; churnBudget >= 1.0 && roots->m_tableSize > 0; churnBudget -= 1.0)
+        {
+            auto index = random() % roots->m_tableSize;
+            auto* old = roots->m_table[index];
+            roots->m_table[index] = MakeNode(nextId++);
+            FreeNode(old);
+        }
+
+        nextTick += std::chrono::microseconds(options.m_tickUs);
+        std::this_thread::sleep_until(nextTick);
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GE::Synthetic
+{
+    constexpr uint64_t kAliveMagic = 0x4E4F4445414C4956;  // "NODEALIV"
+    constexpr uint64_t kFreedMagic = 0x4445414444454144;  // "DEADDEAD"
+    constexpr size_t kPayloadSize = 40;
+
+    /*
+     * Every node is written as: m_counter, payload, m_counterCopy. A reader that sees different counters caught a torn write.
+     */
+    struct Node
+    {
+        Node* m_next = nullptr;
+        uint64_t m_magic = kAliveMagic;
+        uint64_t m_id = 0;
+        uint64_t m_counter = 0;
+        uint8_t m_payload[kPayloadSize] = {};
+        uint64_t m_counterCopy = 0;
+    };
+
+    /*
+     * Content of the append-only log, byte at aIndex never changes once written.
+     */
+    constexpr uint8_t LogByte(size_t aIndex)
+    {
+        return static_cast<uint8_t>(aIndex * 131 % 251);
+    }
+
+    /*
+     * Published by the target on stdout as "roots 0x<address>".
+     * m_log grows by appending until its capacity is reached, m_logSize is published after the appended bytes.
+     */
+    struct Roots
+    {
+        uint64_t m_tick = 0;
+        Node* m_listHead = nullptr;
+        Node** m_table = nullptr;
+        uint64_t m_tableSize = 0;
+        uint64_t m_listSize = 0;
+        uint8_t* m_log = nullptr;
+        uint64_t m_logSize = 0;
+    };
+}